@@ -0,0 +1,125 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    unescape_bench.cc
+ * \brief   Microbenchmark of RegEscape::unescape() on real registry sections
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "reg_escape.h"
+#include <chrono>
+#include <cstddef>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#ifndef BENCH_DATA_DIR
+#define BENCH_DATA_DIR "bench/data"
+#endif
+
+static const std::chrono::milliseconds MinDuration{500}; /*!< Each data set is decoded repeatedly for at least this time */
+
+/**
+ * \brief Read the value lines of all the registry keys that start with the key prefix (still escaped, as stored in the file)
+ * \param[in] file_path Registry file
+ * \param[in] key_prefix Start of the key name, always starting with '[' (eg. [Software\\\\Wine\\\\MenuFiles])
+ * \throws runtime_error when the file can't be read or no lines are found
+ * \return Value lines of the matching keys
+ */
+static std::vector<std::string> read_key_lines(const std::string& file_path, const std::string& key_prefix)
+{
+  std::ifstream file(file_path);
+  if (!file)
+    throw std::runtime_error("Could not open the registry file: " + file_path);
+
+  std::vector<std::string> lines;
+  bool is_matching_key = false;
+  std::string line;
+  while (std::getline(file, line))
+  {
+    if (line.starts_with('['))
+      is_matching_key = line.starts_with(key_prefix);
+    else if (is_matching_key && !line.empty() && !line.starts_with('#'))
+      lines.push_back(line);
+  }
+  if (lines.empty())
+    throw std::runtime_error("No lines found for " + key_prefix + " in: " + file_path);
+  return lines;
+}
+
+/**
+ * \brief Decode all the lines repeatedly for at least MinDuration, and print the time per line and the throughput
+ * \param[in] name Name of the data set
+ * \param[in] lines Escaped registry lines
+ */
+static void run(const std::string& name, const std::vector<std::string>& lines)
+{
+  std::size_t bytes = 0;
+  std::size_t escaped_lines = 0;
+  for (const std::string& line : lines)
+  {
+    bytes += line.size();
+    if (line.find('\\') != std::string::npos)
+      ++escaped_lines;
+  }
+
+  // Warm-up, the output size is summed so the calls can't be optimized away
+  std::size_t checksum = 0;
+  for (const std::string& line : lines)
+    checksum += RegEscape::unescape(line).size();
+
+  std::size_t rounds = 0;
+  auto start = std::chrono::steady_clock::now();
+  std::chrono::steady_clock::duration elapsed;
+  do
+  {
+    for (const std::string& line : lines)
+      checksum += RegEscape::unescape(line).size();
+    ++rounds;
+    elapsed = std::chrono::steady_clock::now() - start;
+  } while (elapsed < MinDuration);
+
+  double seconds = std::chrono::duration<double>(elapsed).count();
+  double ns_per_line = seconds * 1e9 / static_cast<double>(rounds * lines.size());
+  double mb_per_second = static_cast<double>(rounds * bytes) / seconds / 1e6;
+  std::cout << std::left << std::setw(12) << name << std::right << std::setw(5) << lines.size() << " lines (" << escaped_lines
+            << " with escapes)  " << std::fixed << std::setprecision(1) << std::setw(8) << ns_per_line << " ns/line  " << std::setw(8)
+            << mb_per_second << " MB/s  (checksum " << checksum << ")" << std::endl;
+}
+
+/**
+ * \brief Benchmark the registry decoder on the Start Menu and Uninstall sample sections (bench/data)
+ * \param[in] argc Number of arguments
+ * \param[in] argv Optional data directory as first argument
+ * \return Exit code
+ */
+int main(int argc, char* argv[])
+{
+  std::string data_dir = (argc > 1) ? argv[1] : BENCH_DATA_DIR;
+  try
+  {
+    run("Start Menu", read_key_lines(data_dir + "/menu_files.reg", "[Software\\\\Wine\\\\MenuFiles]"));
+    run("Uninstall", read_key_lines(data_dir + "/uninstall.reg", "[Software\\\\Microsoft\\\\Windows\\\\CurrentVersion\\\\Uninstall\\\\"));
+  }
+  catch (const std::runtime_error& error)
+  {
+    std::cerr << "Error: " << error.what() << std::endl;
+    return 1;
+  }
+  return 0;
+}
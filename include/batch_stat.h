@@ -0,0 +1,63 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    batch_stat.h
+ * \brief   Retrieve the status of many files at once
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * \brief Status of a single file (symlinks are followed)
+ */
+struct FileStatus
+{
+  bool exists = false;        /*!< File exists and its status could be retrieved */
+  mode_t mode = 0;            /*!< File type and permissions */
+  std::int64_t size = 0;      /*!< File size in bytes */
+  std::int64_t mtime_sec = 0; /*!< Modification time */
+  long mtime_nsec = 0;        /*!< Nanoseconds part of the modification time */
+
+  /// is existing directory
+  bool is_directory() const;
+  /// is existing regular file
+  bool is_regular_file() const;
+};
+
+/**
+ * \class BatchStat
+ * \brief Retrieve the status of many files at once. All the lookups are submitted together to the kernel using io_uring (statx),
+ * so the round trips of network storage overlap. Falls back to parallel stat() calls when io_uring is not available (Linux < 5.6, or build without io_uring headers).
+ */
+class BatchStat
+{
+public:
+  static std::vector<FileStatus> stat_files(const std::vector<std::string>& file_paths);
+  static FileStatus stat_file(const std::string& file_path);
+
+private:
+  BatchStat() = delete;
+
+#ifdef HAVE_IO_URING_STATX
+  static bool stat_files_io_uring(const std::vector<std::string>& file_paths, std::vector<FileStatus>& statuses);
+#endif
+  static void stat_files_fallback(const std::vector<std::string>& file_paths, std::vector<FileStatus>& statuses);
+};
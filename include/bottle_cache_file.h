@@ -0,0 +1,55 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    bottle_cache_file.h
+ * \brief   Cache file of the Wine bottle details
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "bottle_probe.h"
+#include <map>
+#include <string>
+
+/**
+ * \brief Cached details of a Wine bottle
+ */
+struct BottleCacheEntry
+{
+  std::string file_stamp; /*!< Modification times of the bottle files the details are retrieved from, see BottleCacheFile::get_file_stamp() */
+  BottleProbeData data;
+};
+
+/**
+ * \class BottleCacheFile
+ * \brief Bottle details cache file helper methods, the cached details of a bottle are valid as long as its file stamp is unchanged
+ */
+class BottleCacheFile
+{
+public:
+  // Singleton
+  static BottleCacheFile& get_instance();
+
+  static bool write_cache_file(const std::map<std::string, BottleCacheEntry>& entries);
+  static std::map<std::string, BottleCacheEntry> read_cache_file();
+  static std::string get_file_stamp(const std::string& prefix_path);
+
+private:
+  BottleCacheFile();
+  ~BottleCacheFile();
+  BottleCacheFile(const BottleCacheFile&) = delete;
+  BottleCacheFile& operator=(const BottleCacheFile&) = delete;
+};
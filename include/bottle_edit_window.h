@@ -22,6 +22,7 @@
 
 #include "bottle_types.h"
 #include "busy_dialog.h"
+#include <cstddef>
 #include <gtkmm.h>
 
 using std::string;
@@ -39,6 +40,7 @@ struct UpdateBottleStruct
   BottleTypes::AudioDriver audio;
   bool is_debug_logging;
   int debug_log_level;
+  std::size_t operation_id; /*!< Operation number, passed back to BottleEditWindow::on_bottle_updated() */
 };
 
 /**
@@ -61,7 +63,7 @@ public:
   void bottle_removed();
 
   // Signal handlers
-  virtual void on_bottle_updated();
+  virtual void on_bottle_updated(std::size_t operation_id);
 
 protected:
   // Child widgets
@@ -105,4 +107,5 @@ private:
   void log_level_sensitive(bool sensitive);
 
   BottleItem* active_bottle_; /*!< Current active bottle */
+  std::size_t operation_id_;  /*!< Operation number of the last save, only its result closes the window */
 };
@@ -0,0 +1,40 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    bottle_list_model_column.h
+ * \brief   Bottle list model column (for tree view)
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <gtkmm/treemodel.h>
+#include <gtkmm/treemodelcolumn.h>
+
+class BottleItem;
+
+/**
+ * \brief Only the bottle is stored in the model, the visible rows are rendered from the bottle data
+ */
+class BottleListModelColumns : public Gtk::TreeModel::ColumnRecord
+{
+public:
+  BottleListModelColumns()
+  {
+    add(bottle);
+  }
+
+  Gtk::TreeModelColumn<BottleItem*> bottle;
+};
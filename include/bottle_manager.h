@@ -24,11 +24,18 @@
 #include <list>
 #include <map>
 #include <mutex>
+#include <set>
 #include <string>
 #include <thread>
 
+#include "bottle_cache_file.h"
+#include "bottle_probe.h"
+#include "bottle_record.h"
 #include "bottle_types.h"
 #include "general_config_struct.h"
+#include "helper.h"
+#include "job_scheduler.h"
+#include "worker_pool.h"
 
 using std::string;
 
@@ -48,13 +55,15 @@ public:
   sigc::signal<void> reset_active_bottle;               /*!< Send signal: Clear the current active bottle */
   sigc::signal<void> bottle_removed;                    /*!< Send signal: When the bottle is confirmed to be removed */
   Glib::Dispatcher finished_package_install_dispatcher; /*!< Signal that Wine package install is completed */
+  sigc::signal<void> jobs_changed;                      /*!< Send signal: When the job list is changed */
 
   explicit BottleManager(MainWindow& main_window);
   virtual ~BottleManager();
 
   void prepare();
-  void update_config_and_bottles(bool is_startup);
+  void update_config_and_bottles();
   void new_bottle(SignalController* caller,
+                  std::size_t operation_id,
                   const Glib::ustring& name,
                   BottleTypes::Windows windows_version,
                   BottleTypes::Bit bit,
@@ -62,6 +71,7 @@ public:
                   bool disable_gecko_mono,
                   BottleTypes::AudioDriver audio);
   void update_bottle(SignalController* caller,
+                     std::size_t operation_id,
                      const Glib::ustring& name,
                      const Glib::ustring& folder_name,
                      const Glib::ustring& description,
@@ -72,7 +82,7 @@ public:
                      int debug_log_level);
   void delete_bottle();
   void set_active_bottle(BottleItem* bottle);
-  const Glib::ustring& get_error_message() const;
+  std::vector<JobInfo> get_jobs() const;
 
   // Signal handlers
   void run_executable(string filename, bool is_msi_file);
@@ -91,33 +101,130 @@ public:
 
 private:
   // Synchronizes access to data members using mutexes
-  mutable std::mutex error_message_mutex_;
-  mutable std::mutex output_loging_mutex_;
+  std::mutex probe_results_mutex_;
   Glib::Dispatcher update_bottles_dispatcher_; /*!< Dispatcher if the bottle list needs to be updated, from thread */
-  Glib::Dispatcher write_log_dispatcher_;      /*!< Dispatcher if we can write the output logging to disk */
+  Glib::Dispatcher probe_finished_dispatcher_; /*!< Dispatcher if the details of a bottle are retrieved, from thread */
+  std::mutex disk_usage_results_mutex_;
+  Glib::Dispatcher disk_usage_dispatcher_;   /*!< Dispatcher if the disk usage of a bottle is calculated, from thread */
+  Glib::Dispatcher jobs_changed_dispatcher_; /*!< Dispatcher if the job list is changed, from thread */
+  std::mutex scan_results_mutex_;
+  Glib::Dispatcher scan_finished_dispatcher_; /*!< Dispatcher if a bottle location is scanned, from thread */
+
+  /**
+   * \brief Found bottle directories of a bottle location, waiting to be applied in the GUI thread
+   */
+  struct ScanResult
+  {
+    std::size_t generation;        /*!< Scan generation the location was scanned for */
+    std::size_t index;             /*!< Index in the scanned bottle locations */
+    std::vector<BottlePath> paths; /*!< Found bottle directories */
+  };
+
+  /**
+   * \brief Retrieved bottle details, waiting to be applied in the GUI thread
+   */
+  struct ProbeResult
+  {
+    std::size_t generation;  /*!< Bottle list generation the probe was started for */
+    std::size_t sequence;    /*!< Sequence number of the probe */
+    std::string prefix_path; /*!< Bottle prefix, the index in the bottle list changes when bottles are added */
+    std::string file_stamp;  /*!< File stamp of the bottle before the details are retrieved */
+    bool is_from_cache;      /*!< The details are restored from the cache file */
+    BottleProbeData data;
+  };
+
+  /**
+   * \brief Calculated disk usage, waiting to be applied in the GUI thread
+   */
+  struct DiskUsageResult
+  {
+    std::size_t generation;  /*!< Bottle list generation the calculation was started for */
+    std::string prefix_path; /*!< Bottle prefix */
+    std::int64_t disk_usage; /*!< Allocated disk space in bytes, -1 when unknown */
+  };
 
   MainWindow& main_window_;
-  string bottle_location_;
-  std::list<BottleItem> bottles_;
+  string bottle_location_;                     /*!< Default bottle location, where new bottles are created */
+  std::vector<string> bottle_locations_;       /*!< All the bottle locations (default location first) */
+  int bottle_scan_depth_;                      /*!< Number of directory levels to look for bottles in the bottle locations */
+  std::vector<BottleRecord> records_;          /*!< Bottle data, in the same order as the rows */
+  std::map<string, std::size_t> record_index_; /*!< Index in records_, by prefix path */
+  std::set<Glib::ustring> wine_versions_;      /*!< Interned Wine versions, shared by the bottle records */
+  std::list<BottleItem> bottles_;              /*!< List box rows, build from the bottle records */
+  std::vector<BottleItem*> bottle_rows_;       /*!< List box rows, by index in records_ */
+  const Glib::ustring* wine_version_;          /*!< Interned Wine version, set on the bottle records */
   BottleItem* active_bottle_;
   bool is_display_default_wine_machine_;
   bool is_wine64_bit_;
   bool is_logging_stderr_;
-  int previous_active_bottle_index_;
-  std::size_t previous_bottles_list_size_;
 
-  //// error_message is used by both the GUI thread and NewBottle thread (used a 'temp' location)
-  Glib::ustring error_message_;
-  std::string logging_bottle_prefix_;
-  std::string output_logging_;
+  std::vector<ProbeResult> probe_results_;               /*!< Protected by probe_results_mutex_ */
+  std::vector<DiskUsageResult> disk_usage_results_;      /*!< Protected by disk_usage_results_mutex_ */
+  std::size_t probe_generation_;                         /*!< Incremented each time the bottle list is refreshed (only used in GUI thread) */
+  std::size_t probe_sequence_;                           /*!< Incremented for each started probe (only used in GUI thread) */
+  std::map<string, std::size_t> latest_probes_;          /*!< Sequence number of the latest probe, by prefix path (only used in GUI thread) */
+  std::size_t pending_probes_;                           /*!< Number of probes of the current generation not finished yet (only used in GUI thread) */
+  std::map<std::string, BottleCacheEntry> bottle_cache_; /*!< Cached bottle details, by prefix path (only used in GUI thread) */
+  bool is_bottle_cache_changed_;                         /*!< Cache file needs to be written after the bottles are loaded */
+  std::vector<ScanResult> scan_results_;                 /*!< Protected by scan_results_mutex_ */
+  std::size_t scan_generation_;                          /*!< Incremented each time the bottle locations are scanned (only used in GUI thread) */
+  std::vector<string> scanned_locations_;                /*!< Bottle locations of the latest scan (only used in GUI thread) */
+  std::vector<std::vector<BottlePath>> scanned_paths_;   /*!< Found bottle directories, by index in scanned_locations_ (only used in GUI thread) */
+  bool is_scan_applied_;                                 /*!< A location of the latest scan is applied to the bottle list (only used in GUI thread) */
+
+  std::map<string, Glib::RefPtr<Gio::FileMonitor>> bottle_location_monitors_; /*!< Watches the bottle locations for added/removed bottles */
+  std::map<string, Glib::RefPtr<Gio::FileMonitor>> prefix_monitors_;          /*!< Watches the bottle files, by prefix path */
+  std::set<string> changed_prefixes_;                                         /*!< Bottles with changed files, handled after the refresh timeout */
+  bool is_bottle_location_changed_;                                           /*!< Bottles are added/removed, handled after the refresh timeout */
+  sigc::connection refresh_timeout_;                                          /*!< Timeout to coalesce the file changes */
+  std::set<string> rename_destinations_;                                      /*!< New prefixes of the bottles being renamed */
+  std::mutex rename_destinations_mutex_;                                      /*!< Protects rename_destinations_ (released in the job thread) */
+  JobScheduler job_scheduler_; /*!< Runs the bottle actions (the jobs use the dispatchers above) */
+  WorkerPool scan_pool_;       /*!< Worker threads for scanning the bottle locations in parallel (the jobs use the members above) */
+  WorkerPool disk_usage_pool_; /*!< Worker threads for calculating the disk usage of the bottles in the background (the jobs use the members above) */
+  WorkerPool probe_pool_;      /*!< Worker threads for retrieving the bottle details in parallel (destructed first, the jobs use the members above) */
 
   // Signal handlers
-  virtual void write_log_to_file();
+  void on_bottle_paths_found();
+  void on_bottle_details_retrieved();
+  void on_disk_usage_retrieved();
+  void on_bottle_location_changed(const Glib::RefPtr<Gio::File>& file, const Glib::RefPtr<Gio::File>& other_file, Gio::FileMonitorEvent event);
+  void on_prefix_changed(const Glib::RefPtr<Gio::File>& file,
+                         const Glib::RefPtr<Gio::File>& other_file,
+                         Gio::FileMonitorEvent event,
+                         const string& prefix_path);
+  bool on_refresh_timeout();
 
+  static void create_bottle(bool is_wine64_bit,
+                            const string& prefix_path,
+                            const Glib::ustring& name,
+                            BottleTypes::Windows windows_version,
+                            BottleTypes::Bit bit,
+                            const Glib::ustring& virtual_desktop_resolution,
+                            bool disable_gecko_mono,
+                            BottleTypes::AudioDriver audio);
+  static void change_bottle(bool is_wine64_bit,
+                            const string& prefix_path,
+                            const Glib::ustring& name,
+                            const Glib::ustring& folder_name,
+                            const Glib::ustring& description,
+                            BottleTypes::Windows windows_version,
+                            const Glib::ustring& virtual_desktop_resolution,
+                            BottleTypes::AudioDriver audio,
+                            bool is_debug_logging,
+                            int debug_log_level);
   GeneralConfigData load_and_save_general_config();
   bool is_bottle_not_null();
   string get_deinstall_mono_command();
   string get_wine_version();
-  std::vector<string> get_bottle_paths();
-  std::list<BottleItem> create_wine_bottles(std::vector<string> bottle_dirs);
+  void create_bottle_location();
+  void scan_bottle_locations();
+  void set_bottle_paths(const std::vector<string>& bottle_dirs, bool is_refresh);
+  void retrieve_bottle_details();
+  void retrieve_bottle_details(std::size_t index);
+  void retrieve_disk_usage();
+  void retrieve_disk_usage(std::size_t index);
+  void update_file_monitors();
+  void schedule_refresh();
+  void save_bottle_cache();
 };
@@ -21,6 +21,7 @@
 #pragma once
 
 #include "bottle_types.h"
+#include <cstddef>
 #include <gtkmm.h>
 
 /**
@@ -43,7 +44,8 @@ public:
                   bool& disable_gecko_mono,
                   BottleTypes::AudioDriver& audio);
 
-  void bottle_created();
+  std::size_t start_operation();
+  void bottle_created(std::size_t operation_id);
 
   // Child widgets
   Gtk::Box vbox;
@@ -70,7 +72,8 @@ public:
   Gtk::ProgressBar loading_bar;
 
 private:
-  sigc::connection timer_; /*!< Timer connection */
+  sigc::connection timer_;   /*!< Timer connection */
+  std::size_t operation_id_; /*!< Operation number of the last applied bottle, only its result closes the wizard */
 
   // Signal handlers
   void on_assistant_apply();
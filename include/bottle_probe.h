@@ -0,0 +1,61 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    bottle_probe.h
+ * \brief   Retrieve all the details of a Wine bottle at once
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <glibmm/ustring.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "app_list_struct.h"
+#include "bottle_types.h"
+#include "wine_defaults.h"
+
+/**
+ * \brief Details of a Wine bottle (all the BottleItem fields)
+ */
+struct BottleProbeData
+{
+  Glib::ustring name = "";
+  Glib::ustring folder_name = "";
+  Glib::ustring description = "";
+  Glib::ustring virtual_desktop = "";
+  BottleTypes::Bit bit = BottleTypes::Bit::win32;
+  Glib::ustring c_drive_location = "- Unknown -";
+  Glib::ustring last_time_wine_updated = "- Unknown -";
+  BottleTypes::AudioDriver audio_driver = BottleTypes::AudioDriver::pulseaudio;
+  BottleTypes::Windows windows = WineDefaults::WindowsOs;
+  bool debug_logging_enabled = false;
+  int debug_log_level = 1;
+  bool status = false;
+  std::map<int, ApplicationData> app_list;
+  std::vector<std::string> warnings; /*!< Non-fatal error messages, the related fields keep their default value */
+};
+
+/**
+ * \class BottleProbe
+ * \brief Retrieve all the details of a Wine bottle, every file is checked and read only once (thread-safe)
+ */
+class BottleProbe
+{
+public:
+  static BottleProbeData probe(const std::string& prefix_path);
+};
@@ -0,0 +1,54 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    bottle_record.h
+ * \brief   Wine bottle data struct
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "app_list_struct.h"
+#include "bottle_types.h"
+#include "wine_defaults.h"
+#include <cstdint>
+#include <glibmm/ustring.h>
+#include <map>
+
+/**
+ * \brief Data of a Wine bottle, without any GTK widgets (see BottleItem for the list box row)
+ */
+struct BottleRecord
+{
+  Glib::ustring prefix_path = ""; /*!< Wine prefix location, unique key of the bottle */
+  Glib::ustring name = "";
+  Glib::ustring folder_name = "";
+  Glib::ustring description = "";
+  Glib::ustring c_drive_location = "- Unknown -";
+  Glib::ustring last_time_wine_updated = "- Unknown -";
+  Glib::ustring virtual_desktop = ""; /*!< Empty string is disabled */
+  const Glib::ustring* wine_version = nullptr; /*!< Interned string, shared by all bottles */
+  std::map<int, ApplicationData> app_list;
+  BottleTypes::Windows windows = WineDefaults::WindowsOs;
+  BottleTypes::Bit bit = BottleTypes::Bit::win32;
+  BottleTypes::AudioDriver audio_driver = WineDefaults::AudioDriver;
+  int debug_log_level = 1;
+  bool is_wine64_bit = false;
+  bool status = false;
+  bool debug_logging_enabled = false;
+  bool is_loading = true;            /*!< Details are not yet retrieved */
+  std::int64_t disk_usage = -1;      /*!< Allocated disk space in bytes, -1 when unknown */
+  bool is_disk_usage_loading = true; /*!< Disk usage is not yet calculated */
+};
@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    disk_usage.h
+ * \brief   Disk usage of directory trees
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <sys/stat.h>
+
+/**
+ * \class DiskUsage
+ * \brief Disk usage of directory trees (like 'du'), the usage of each directory is cached by its modification time.
+ * A directory is only read again when entries are added, removed or renamed, the other directories are only checked with a stat.
+ * \note Files that grow or shrink in place are not noticed, until their directory is changed. Hard links are counted for each link (like 'du -l').
+ */
+class DiskUsage
+{
+public:
+  // Singleton
+  static DiskUsage& get_instance();
+
+  static std::int64_t get_disk_usage(const std::string& dir_path);
+
+private:
+  DiskUsage();
+  ~DiskUsage();
+  DiskUsage(const DiskUsage&) = delete;
+  DiskUsage& operator=(const DiskUsage&) = delete;
+
+  static std::int64_t get_directory_usage(const std::string& dir_path, const struct stat& dir_stat);
+};
@@ -21,10 +21,13 @@
 #pragma once
 
 #include <string>
+#include <vector>
 
 struct GeneralConfigData
 {
   std::string default_folder;
+  std::vector<std::string> additional_folders;
+  int folder_scan_depth;
   bool display_default_wine_machine;
   bool prefer_wine64;
   bool enable_logging_stderr;
@@ -21,7 +21,9 @@
 #pragma once
 
 #include <glibmm/dispatcher.h>
+#include <memory>
 #include <string>
+#include <sys/stat.h>
 #include <utility>
 #include <vector>
 
@@ -31,12 +33,28 @@
 using std::endl;
 using std::string;
 
+// Forward declaration
+class LogSink;
+class RegistryIndex;
+class BottleProbe;
+
+/**
+ * \brief Bottle directory found in a bottle location
+ */
+struct BottlePath
+{
+  string path;      /*!< Path within the bottle location */
+  string real_path; /*!< Canonical path (symlinks resolved), a bottle found via multiple paths is only listed once */
+};
+
 /**
  * \class Helper
  * \brief Provide some helper methods for Bottle Manager and CLI
  */
 class Helper
 {
+  friend class BottleProbe;
+
 public:
   // Signals
   Glib::Dispatcher failure_on_exec; /*!< Dispatch signal (thus in main thread) when exit code was non-zero */
@@ -44,11 +62,21 @@ public:
   // Singleton
   static Helper& get_instance();
 
-  static std::vector<string> get_bottles_paths(const string& dir_path, bool display_default_wine_machine);
-  static string run_program(const string& prefix_path, int debug_log_level, const string& program, bool give_error = true, bool stderr_output = true);
-  static string run_program_under_wine(
-      bool wine_64_bit, const string& prefix_path, int debug_log_level, const string& program, bool give_error = true, bool stderr_output = true);
-  static void write_to_log_file(const string& logging_bottle_prefix, const string& logging);
+  static std::vector<BottlePath> find_bottles_paths(const string& dir_path, int depth);
+  static std::vector<string> merge_bottles_paths(const std::vector<std::vector<BottlePath>>& found_paths, bool display_default_wine_machine);
+  static void run_program(const string& prefix_path,
+                          int debug_log_level,
+                          const string& program,
+                          LogSink& log_sink,
+                          bool give_error = true,
+                          bool stderr_output = true);
+  static void run_program_under_wine(bool wine_64_bit,
+                                     const string& prefix_path,
+                                     int debug_log_level,
+                                     const string& program,
+                                     LogSink& log_sink,
+                                     bool give_error = true,
+                                     bool stderr_output = true);
   static string get_log_file_path(const string& logging_bottle_prefix);
   static void wait_until_wineserver_is_terminated(const string& prefix_path);
   static int determine_wine_executable();
@@ -75,10 +103,10 @@ public:
   static bool file_exists(const string& filer_path);
   static void install_or_update_winetricks();
   static void self_update_winetricks();
-  static void set_windows_version(const string& prefix_path, BottleTypes::Windows windows);
-  static void set_virtual_desktop(const string& prefix_path, string resolution);
-  static void disable_virtual_desktop(const string& prefix_path);
-  static void set_audio_driver(const string& prefix_path, BottleTypes::AudioDriver audio_driver);
+  static void set_windows_version(bool wine_64_bit, const string& prefix_path, BottleTypes::Windows windows);
+  static void set_virtual_desktop(bool wine_64_bit, const string& prefix_path, string resolution);
+  static void disable_virtual_desktop(bool wine_64_bit, const string& prefix_path);
+  static void set_audio_driver(bool wine_64_bit, const string& prefix_path, BottleTypes::AudioDriver audio_driver);
   static std::vector<string> get_menu_items(const string& prefix_path);
   static std::vector<std::pair<string, string>> get_desktop_items(const string& prefix_path);
   static string log_level_to_winedebug_string(int log_level);
@@ -97,13 +125,22 @@ private:
   Helper(const Helper&) = delete;
   Helper& operator=(const Helper&) = delete;
 
+  static void find_bottles_paths(const string& dir_path, int depth, std::vector<BottlePath>& list);
+  static BottlePath get_bottle_path(const string& path);
+  static bool is_wine_prefix(const string& dir_path);
   static string exec(const char* cmd);
-  static string exec_error_message(const char* cmd);
-  static int close_exec_stream(std::FILE* file);
   static void write_file(const string& filename, const string& contents);
   static string read_file(const string& filename);
   static string get_winetricks_version();
+  static std::shared_ptr<const RegistryIndex> load_registry(const string& file_path);
+  static BottleTypes::Windows parse_windows_version(const RegistryIndex& user_reg, const string& prefix_path);
+  static BottleTypes::Bit parse_windows_bitness(const RegistryIndex& user_reg, const string& prefix_path);
+  static BottleTypes::AudioDriver parse_audio_driver(const RegistryIndex& user_reg);
+  static string parse_virtual_desktop(const RegistryIndex& user_reg);
+  static string get_registry_snapshot_path(const string& file_path);
+  static void save_registry_snapshot(const RegistryIndex& registry, const string& snapshot_path, const struct stat& source_stat);
   static string get_reg_value(const string& filename, const string& key_name, const string& value_name);
+  static std::vector<string> get_reg_values(const string& file_path, const std::vector<std::pair<string, string>>& key_value_names);
   static std::vector<string> get_reg_keys(const string& file_path, const string& key_name);
   static std::vector<std::pair<string, string>> get_reg_keys_name_data_pair(const string& file_path, const string& key_name);
   static std::vector<std::pair<string, string>>
@@ -119,11 +156,17 @@ private:
                                                                    const string& key_value_filter = "",
                                                                    const string& key_name_ignore_filter = "");
   static string get_reg_meta_data(const string& filename, const string& meta_value_name);
+  static bool is_wineserver_running(const string& prefix_path);
+  static void set_reg_value(
+      bool wine_64_bit, const string& prefix_path, const string& reg_file, const string& key_name, const string& value_name, const string& data);
+  static void delete_reg_value(bool wine_64_bit, const string& prefix_path, const string& reg_file, const string& key_name, const string& value_name);
+  static void update_reg_file(const string& file_path, const string& key_name, const string& value_name, const string* data);
+  static string get_reg_key_path(const string& reg_file, const string& key_name);
+  static string escape_reg_string(const string& src);
   static string get_bottle_dir_from_prefix(const string& prefix_path);
   static std::vector<string> read_file_lines(const string& file_path);
   static std::vector<string> split(const string& s, const char delimiter);
   static bool case_insensitive_compare(const std::string& a, const std::string& b);
-  static string unescape_reg_key_data(const string& src);
   static string string2hex(const std::string& str, bool capital = false);
   static string hex2string(const std::string& hexstr);
 };
@@ -0,0 +1,81 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    job_scheduler.h
+ * \brief   Runs the bottle actions, with a job list
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "worker_pool.h"
+#include <chrono>
+#include <cstddef>
+#include <functional>
+#include <memory>
+#include <string>
+#include <vector>
+
+/**
+ * \brief State of a job
+ */
+enum class JobState
+{
+  Queued,   /*!< Waiting for a worker thread, or for the previous job of the same bottle */
+  Running,  /*!< Job is running */
+  Finished, /*!< Job is finished */
+  Failed    /*!< Job is stopped by an exception */
+};
+
+/**
+ * \brief Job in the job list
+ */
+struct JobInfo
+{
+  std::size_t id;                                   /*!< Unique job number, in the order the jobs are added */
+  std::string prefix_path;                          /*!< Bottle prefix the job runs in */
+  std::string description;                          /*!< Short description, eg. "Install DXVK" */
+  bool is_exclusive;                                /*!< Exclusive jobs of the same bottle run one after the other */
+  JobState state;                                   /*!< Current state */
+  std::chrono::system_clock::time_point start_time; /*!< Time the job is started (only valid when it is started) */
+  std::chrono::steady_clock::duration duration;     /*!< Running time, up till now when the job is still running */
+};
+
+/**
+ * \class JobScheduler
+ * \brief Runs the bottle actions in the background and keeps a list of the jobs.
+ * Exclusive jobs (that change a bottle, eg. installs) run on a fixed number of worker threads, one job at a time per bottle.
+ * Launched programs are not limited, they run in their own thread until the program is closed.
+ */
+class JobScheduler
+{
+public:
+  explicit JobScheduler(unsigned int thread_count, std::function<void()> on_jobs_changed = nullptr);
+  ~JobScheduler();
+  JobScheduler(const JobScheduler&) = delete;
+  JobScheduler& operator=(const JobScheduler&) = delete;
+
+  std::size_t launch(const std::string& prefix_path, const std::string& description, std::function<void()> job);
+  std::size_t post(const std::string& prefix_path, const std::string& description, std::function<void()> job);
+  std::vector<JobInfo> get_jobs() const;
+  bool is_busy(const std::string& prefix_path) const;
+
+private:
+  struct JobList;
+  std::shared_ptr<JobList> jobs_; /*!< Shared with the launched programs, which can outlive the scheduler */
+  WorkerPool pool_;               /*!< Worker threads for the exclusive jobs (destructed first, the jobs use the job list) */
+
+  void run_exclusive(std::size_t id, const std::string& prefix_path, std::function<void()> job);
+};
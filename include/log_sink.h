@@ -0,0 +1,52 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    log_sink.h
+ * \brief   Stream program output to a log file
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <chrono>
+#include <string>
+#include <string_view>
+
+/**
+ * \class LogSink
+ * \brief Appends program output to a log file while the program is running. At most 64 KiB (or half a second) of output is
+ * kept in memory before it is passed to the log writer, the log file is only created when there is output.
+ * \note The flush interval is only checked when output is written, call flush() when the program is idle (see ProcessOptions::idle_callback).
+ */
+class LogSink
+{
+public:
+  static constexpr std::chrono::milliseconds FlushInterval{500}; /*!< Slow output is passed to the log writer at least this often */
+
+  explicit LogSink(const std::string& file_path, bool is_enabled = true);
+  ~LogSink();
+  LogSink(const LogSink&) = delete;
+  LogSink& operator=(const LogSink&) = delete;
+
+  void write(std::string_view output);
+  void flush();
+
+private:
+  std::string file_path_;
+  bool is_enabled_;                                  /*!< Output is discarded when disabled */
+  std::string buffer_;                               /*!< Output not yet passed to the log writer */
+  char last_char_;                                   /*!< Last character of the output */
+  std::chrono::steady_clock::time_point last_flush_; /*!< Time of the last flush */
+};
@@ -0,0 +1,71 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    log_writer.h
+ * \brief   Single writer of the log records of all the running programs
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <atomic>
+#include <cstddef>
+#include <string>
+#include <thread>
+
+/**
+ * \class LogWriter
+ * \brief Appends the log records of all the running programs to their log files, from a single writer thread.
+ * The records are pushed on a lock-free multi-producer single-consumer queue, the writer takes all queued records at once
+ * and writes them per log file (in the order they were written).
+ * The amount of data in the queue is limited, producers wait when the writer is behind (the program output then waits in its pipe).
+ * \note The writer is never destructed, launched programs (detached threads) can still write logging during the static destruction.
+ * The queued records are written at exit.
+ */
+class LogWriter
+{
+public:
+  // Singleton
+  static LogWriter& get_instance();
+
+  static void write(const std::string& file_path, std::string data);
+
+private:
+  /**
+   * \brief Log record, linked in the queue
+   */
+  struct LogRecord
+  {
+    std::string file_path; /*!< Log file path */
+    std::string data;      /*!< Data to append to the log file */
+    LogRecord* next;       /*!< Previous pushed record */
+  };
+
+  std::atomic<LogRecord*> queue_head_;        /*!< Last pushed record, nullptr when the queue is empty */
+  std::atomic<std::size_t> bytes_in_flight_;  /*!< Data in the queue or being written, in bytes */
+  std::atomic<bool> is_exiting_;              /*!< The application is exiting, data is written directly */
+  std::atomic<std::size_t> active_producers_; /*!< Producers between the is_exiting_ check and the push, waited for at exit */
+  std::thread writer_thread_;
+
+  LogWriter();
+  ~LogWriter();
+  LogWriter(const LogWriter&) = delete;
+  LogWriter& operator=(const LogWriter&) = delete;
+
+  static void flush_at_exit();
+  void push(LogRecord* record);
+  void leave_producer();
+  void writer_loop();
+};
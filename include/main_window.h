@@ -23,14 +23,19 @@
 #include "app_list_model_column.h"
 #include "app_list_struct.h"
 #include "bottle_item.h"
+#include "bottle_list_model_column.h"
 #include "bottle_new_assistant.h"
 #include "busy_dialog.h"
 #include "general_config_struct.h"
+#include "job_scheduler.h"
 #include "menu.h"
 #include <gtkmm.h>
+#include <cstddef>
 #include <iostream>
 #include <list>
+#include <map>
 #include <string>
+#include <vector>
 
 using std::cout;
 using std::endl;
@@ -50,7 +55,7 @@ public:
   sigc::signal<void> show_configure_window;      /*!< show Settings window signal */
   sigc::signal<void> show_add_app_window;        /*!< show add application window signal */
   sigc::signal<void> show_remove_app_window;     /*!< show remove application window signal */
-  sigc::signal<void, Glib::ustring&, BottleTypes::Windows, BottleTypes::Bit, Glib::ustring&, bool&, BottleTypes::AudioDriver>
+  sigc::signal<void, std::size_t, Glib::ustring&, BottleTypes::Windows, BottleTypes::Bit, Glib::ustring&, bool&, BottleTypes::AudioDriver>
       new_bottle;                                       /*!< Create new Wine Bottle Signal */
   sigc::signal<void, string, bool> run_executable;      /*!< Run an EXE or MSI application in Wine with provided filename */
   sigc::signal<void, string> run_program;               /*!< Run program in Wine */
@@ -66,9 +71,11 @@ public:
 
   void set_wine_bottles(std::list<BottleItem>& bottles);
   void select_row_bottle(BottleItem& bottle);
+  void update_bottle(BottleItem& bottle);
   void reset_detailed_info();
   void reset_application_list();
   void set_general_config(const GeneralConfigData& config_data);
+  void set_jobs(const std::vector<JobInfo>& jobs);
   void show_info_message(const Glib::ustring& message, bool markup = false);
   void show_warning_message(const Glib::ustring& message, bool markup = false);
   void show_error_message(const Glib::ustring& message, bool markup = false);
@@ -79,7 +86,7 @@ public:
 
   // Signal handlers
   virtual void on_new_bottle_button_clicked();
-  virtual void on_new_bottle_created();
+  virtual void on_new_bottle_created(std::size_t operation_id);
   virtual void on_run_button_clicked();
   virtual void on_refresh_app_list_button_clicked();
   virtual void on_hide_window();
@@ -93,14 +100,24 @@ protected:
   bool delete_window(GdkEventAny* any_event);
   Glib::RefPtr<Gio::Settings> window_settings; /*!< Window settings to store our window settings, even during restarts */
 
-  AppListModelColumns app_list_columns; /*!< Application list model columns for app tree view */
+  AppListModelColumns app_list_columns;       /*!< Application list model columns for app tree view */
+  BottleListModelColumns bottle_list_columns; /*!< Bottle list model columns for bottle tree view */
 
   // Child widgets
-  Gtk::Box vbox;    /*!< The main vertical box */
-  Gtk::Paned paned; /*!< The main paned panel (horizontal) */
+  Gtk::Box vbox;            /*!< The main vertical box */
+  Gtk::Paned paned;         /*!< The main paned panel (horizontal) */
+  Gtk::Statusbar statusbar; /*!< Status bar at the bottom, shows the running bottle actions */
   // Left widgets
-  Gtk::ScrolledWindow scrolled_window_listbox; /*!< Scrolled Window container, which contains the listbox */
-  Gtk::ListBox listbox;                        /*!< Listbox in the left panel */
+  Gtk::ScrolledWindow scrolled_window_listbox;                            /*!< Scrolled Window container, which contains the bottle list */
+  Gtk::TreeView bottle_list_treeview;                                     /*!< Bottle list in the left panel */
+  Glib::RefPtr<Gtk::ListStore> bottle_list_store;                         /*!< Bottle list model (using a liststore) */
+  std::map<const BottleItem*, Gtk::TreeModel::iterator> bottle_list_rows; /*!< Row of each bottle in the bottle list model */
+  std::map<string, Glib::RefPtr<Gdk::Pixbuf>> bottle_list_icons;          /*!< Loaded icons of the bottle list, by file name */
+  Gtk::CellRendererPixbuf bottle_windows_renderer_pixbuf;
+  Gtk::CellRendererPixbuf bottle_status_renderer_pixbuf;
+  Gtk::CellRendererText bottle_name_status_renderer_text;
+  Gtk::TreeView::Column bottle_windows_column;
+  Gtk::TreeView::Column bottle_name_status_column;
   // Right widgets
   Gtk::ScrolledWindow detail_grid_scrolled_window_detail; /*!< Scrolled Window container for the detail grid */
   Gtk::ScrolledWindow app_list_scrolled_window;           /*!< Scrolled Window container for app list */
@@ -129,6 +146,7 @@ protected:
   Gtk::Label wine_location_label;     /*!< Wine location text */
   Gtk::Label debug_log_level_label;   /*!< Debug log level text */
   Gtk::Label wine_last_changed_label; /*!< Last changed text */
+  Gtk::Label disk_usage_label;        /*!< Disk usage text */
   Gtk::Label audio_driver_label;      /*!< Audio driver text */
   Gtk::Label virtual_desktop_label;   /*!< Virtual desktop text */
   Gtk::Label description_label;       /*!< description text */
@@ -156,7 +174,7 @@ private:
   GeneralConfigData general_config_data_;
 
   // Signal handlers
-  virtual void on_bottle_row_clicked(Gtk::ListBoxRow* row);
+  virtual void on_bottle_row_clicked();
   virtual void on_app_list_changed();
   virtual void on_application_row_activated(const Gtk::TreeModel::Path& path, Gtk::TreeViewColumn* /* column */);
   virtual void on_new_bottle_apply();
@@ -170,7 +188,11 @@ private:
   void create_left_panel();
   void create_right_panel();
   void set_sensitive_toolbar_buttons(bool sensitive);
-  static void cc_list_box_update_header_func(Gtk::ListBoxRow* list_box_row, Gtk::ListBoxRow* before);
+  BottleItem* get_selected_bottle();
+  Glib::RefPtr<Gdk::Pixbuf> get_bottle_list_icon(const string& filename);
+  void treeview_set_cell_data_bottle_windows(Gtk::CellRenderer* renderer, const Gtk::TreeModel::iterator& iter);
+  void treeview_set_cell_data_bottle_status_icon(Gtk::CellRenderer* renderer, const Gtk::TreeModel::iterator& iter);
+  void treeview_set_cell_data_bottle_name_status(Gtk::CellRenderer* renderer, const Gtk::TreeModel::iterator& iter);
   bool app_list_visible_func(const Gtk::TreeModel::const_iterator& iter);
   void treeview_set_cell_data_name_desc(Gtk::CellRenderer* renderer, const Gtk::TreeModel::iterator& iter);
 };
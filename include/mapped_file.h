@@ -0,0 +1,48 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    mapped_file.h
+ * \brief   Read-only memory-mapped file
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <cstddef>
+#include <string>
+#include <string_view>
+
+/**
+ * \class MappedFile
+ * \brief Map a whole file read-only into memory, the contents is accessible as string_view (zero-copy)
+ */
+class MappedFile
+{
+public:
+  explicit MappedFile(const std::string& file_path);
+  ~MappedFile();
+  MappedFile(const MappedFile&) = delete;
+  MappedFile& operator=(const MappedFile&) = delete;
+
+  /// get file contents
+  std::string_view data() const
+  {
+    return std::string_view(static_cast<const char*>(data_), size_);
+  };
+
+private:
+  void* data_;
+  std::size_t size_;
+};
@@ -0,0 +1,69 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    process_runner.h
+ * \brief   Run a program without a shell (posix_spawn)
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <chrono>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <sys/types.h>
+#include <vector>
+
+/**
+ * \brief Options of a process started by ProcessRunner
+ */
+struct ProcessOptions
+{
+  std::vector<std::string> environment;      /*!< Extra environment variables (NAME=value), override the inherited variables */
+  bool merge_stderr = false;                 /*!< Also read stderr (together with stdout), otherwise stderr is inherited */
+  bool discard_output = false;               /*!< Redirect stdout and stderr to /dev/null */
+  std::chrono::milliseconds idle_timeout{0}; /*!< Call the idle callback each time there is no output for this long (0 is never) */
+  std::function<void()> idle_callback;       /*!< Called while the program is running without output (eg. to flush buffered output) */
+};
+
+/**
+ * \brief Result of a finished process
+ */
+struct ProcessResult
+{
+  int exit_code;      /*!< Exit status, 128 + signal number when terminated by a signal (like the shell) */
+  std::string output; /*!< stdout output (and stderr when merged) */
+};
+
+/**
+ * \class ProcessRunner
+ * \brief Start a program with an argument vector using posix_spawn (no shell), the output is read in large chunks from a non-blocking pipe
+ */
+class ProcessRunner
+{
+public:
+  /// Called for each chunk of output, while the process is running
+  using OutputCallback = std::function<void(std::string_view output)>;
+
+  static ProcessResult run(const std::vector<std::string>& argv, const ProcessOptions& options = {});
+  static int run(const std::vector<std::string>& argv, const OutputCallback& output_callback, const ProcessOptions& options = {});
+
+private:
+  ProcessRunner() = delete;
+
+  static void read_output(int fd, const OutputCallback& output_callback, const ProcessOptions& options);
+  static int wait_for_exit(pid_t pid);
+};
@@ -0,0 +1,37 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    reg_escape.h
+ * \brief   Decoder of the escaped data in the Wine registry files
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <string>
+#include <string_view>
+
+/**
+ * \class RegEscape
+ * \brief Decoder of the escaped registry data, used by Helper (kept separate so it can be benchmarked on its own)
+ */
+class RegEscape
+{
+public:
+  static std::string unescape(std::string_view src);
+
+private:
+  RegEscape() = delete;
+};
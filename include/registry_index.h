@@ -0,0 +1,65 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    registry_index.h
+ * \brief   Parsed in-memory index of a Wine registry file
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include "mapped_file.h"
+#include <map>
+#include <memory>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <sys/stat.h>
+#include <vector>
+
+/**
+ * \class RegistryIndex
+ * \brief Index a Wine registry file (eg. user.reg or system.reg) once, and answer key/value queries from memory.
+ * The file is memory-mapped, all the key names, value names and value data are string_view slices into the mapping (zero-copy).
+ * Only the key section headers are indexed up-front, the lines of a key are only split when that key is queried.
+ * The index can be stored as binary snapshot, which can be memory-mapped again without parsing the registry text.
+ */
+class RegistryIndex
+{
+public:
+  explicit RegistryIndex(const std::string& file_path);
+  RegistryIndex(const RegistryIndex&) = delete;
+  RegistryIndex& operator=(const RegistryIndex&) = delete;
+
+  static std::shared_ptr<const RegistryIndex> from_snapshot(const std::string& snapshot_path, const struct stat& source_stat);
+  std::string to_snapshot(const struct stat& source_stat) const;
+
+  std::vector<std::string_view> get_key_lines(std::string_view key_name) const;
+  std::string get_value(std::string_view key_name, std::string_view value_name) const;
+  std::vector<std::string> get_values(const std::vector<std::pair<std::string, std::string>>& key_value_names) const;
+  std::string get_meta_data(std::string_view meta_value_name) const;
+
+private:
+  MappedFile file_;                                                     /*!< Memory-mapped registry file, owns the data of all views */
+  std::vector<std::string_view> sections_;                              /*!< Key section bodies (the lines below the key), in file order */
+  std::map<std::string_view, std::size_t, std::less<>> key_index_;      /*!< Key name (eg. [Software\\\\Wine]) to section index */
+  std::map<std::string_view, std::string_view, std::less<>> meta_data_; /*!< Meta data at the top of the file (eg. #arch=win32) */
+
+  RegistryIndex(const std::string& snapshot_path, const struct stat& source_stat);
+  const std::string_view* find_section(std::string_view key_name) const;
+  static std::string find_value(const std::string_view* section, std::string_view value_name);
+  static std::vector<std::string_view> split_lines(std::string_view body, bool stop_at_empty_line = true);
+  static std::string remove_quotes(std::string_view data);
+};
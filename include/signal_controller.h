@@ -21,8 +21,12 @@
 #pragma once
 
 #include "bottle_types.h"
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
 #include <gtkmm.h>
-#include <thread>
+#include <mutex>
+#include <utility>
 
 // Forward declaration
 class MainWindow;
@@ -58,21 +62,25 @@ public:
   void dispatch_signals();
 
   // Signal handlers
-  // signal_bottle_created() and signal_bottle_updated() are called from the thread bottle manager,
+  // signal_bottle_created() and signal_bottle_updated() are called from the job thread of the bottle manager,
   // it's executed in the that thread. And can trigger the dispatcher (=thread safe), which gets executed in the GUI
-  // thread.
-  void signal_bottle_created();
-  void signal_bottle_updated();
-  void signal_error_message_during_create();
-  void signal_error_message_during_update();
+  // thread. Each bottle operation calls exactly one of these methods, with the operation number of the dialog that started it.
+  void signal_bottle_created(std::size_t operation_id);
+  void signal_bottle_updated(std::size_t operation_id);
+  void signal_error_message_during_create(std::size_t operation_id, const Glib::ustring& error_message);
+  void signal_error_message_during_update(std::size_t operation_id, const Glib::ustring& error_message);
 
 protected:
 private:
-  void cleanup_bottle_manager_thread();
+  using OperationError = std::pair<std::size_t, Glib::ustring>; /*!< Operation number with its error message */
+
+  void finish_bottle_operation();
+  void finish_bottle_update(std::size_t operation_id);
 
   // slots
   virtual bool on_mouse_button_pressed(GdkEventButton* event);
-  virtual void on_new_bottle(Glib::ustring& name,
+  virtual void on_new_bottle(std::size_t operation_id,
+                             Glib::ustring& name,
                              BottleTypes::Windows windows_version,
                              BottleTypes::Bit bit,
                              Glib::ustring& virtual_desktop_resolution,
@@ -83,6 +91,7 @@ private:
   virtual void on_bottle_updated();
   virtual void on_error_message_created();
   virtual void on_error_message_updated();
+  virtual void on_jobs_changed();
 
   MainWindow* main_window_;
   BottleManager& manager_;
@@ -99,6 +108,12 @@ private:
   Glib::Dispatcher bottle_updated_dispatcher_;
   Glib::Dispatcher error_message_created_dispatcher_;
   Glib::Dispatcher error_message_updated_dispatcher_;
-  // Thread for Bottle Manager (so it doesn't block the GUI thread)
-  std::thread* thread_bottle_manager_;
+  // Bottle operations (create/update) running in the bottle manager jobs (so they don't block the GUI thread)
+  std::mutex bottle_operations_mutex_;
+  std::condition_variable bottle_operations_finished_; /*!< Signaled when a bottle operation is finished */
+  std::size_t running_bottle_operations_;              /*!< Number of bottle operations not finished yet */
+  std::deque<std::size_t> created_operations_;         /*!< Operation number for each emit of bottle_created_dispatcher_ */
+  std::deque<std::size_t> updated_operations_;         /*!< Operation number for each emit of bottle_updated_dispatcher_ */
+  std::deque<OperationError> create_error_messages_;   /*!< Error message for each emit of error_message_created_dispatcher_ */
+  std::deque<OperationError> update_error_messages_;   /*!< Error message for each emit of error_message_updated_dispatcher_ */
 };
@@ -0,0 +1,53 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    worker_pool.h
+ * \brief   Fixed-size pool of worker threads
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#pragma once
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * \class WorkerPool
+ * \brief Bounded number of worker threads, executing the posted jobs in FIFO order
+ */
+class WorkerPool
+{
+public:
+  explicit WorkerPool(unsigned int thread_count = 0);
+  ~WorkerPool();
+  WorkerPool(const WorkerPool&) = delete;
+  WorkerPool& operator=(const WorkerPool&) = delete;
+
+  void post(std::function<void()> job);
+  void cancel_pending();
+
+private:
+  std::mutex mutex_;                      /*!< Protects the job queue and the stopping flag */
+  std::condition_variable job_available_; /*!< Signaled when a job is posted or the pool stops */
+  std::deque<std::function<void()>> jobs_;
+  std::vector<std::thread> threads_;
+  bool is_stopping_;
+
+  void worker_loop();
+};
@@ -0,0 +1,374 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    batch_stat.cc
+ * \brief   Retrieve the status of many files at once
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "batch_stat.h"
+#include "worker_pool.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <latch>
+#include <sys/stat.h>
+#include <unistd.h>
+#ifdef HAVE_IO_URING_STATX
+#include <linux/io_uring.h>
+#include <sys/mman.h>
+#include <sys/syscall.h>
+#endif
+
+static const std::size_t FallbackChunkSize = 8; /*!< Number of lookups per fallback job, smaller batches are not split */
+static const unsigned int FallbackThreads = 8;  /*!< Lookups are mostly waiting on the (network) storage, not on the CPU */
+
+// The io_uring instance is only build when the kernel headers support statx (see CMakeLists.txt)
+#ifdef HAVE_IO_URING_STATX
+static const unsigned int RingEntries = 64; /*!< Number of lookups submitted to the kernel at once */
+
+/**
+ * \brief Minimal io_uring instance (without liburing), only used for statx lookups.
+ * Each thread has its own instance, so no locking is needed.
+ */
+class StatxRing
+{
+public:
+  StatxRing();
+  ~StatxRing();
+  StatxRing(const StatxRing&) = delete;
+  StatxRing& operator=(const StatxRing&) = delete;
+
+  /// is io_uring (with statx) available
+  bool is_available() const
+  {
+    return fd_ >= 0 && is_statx_supported_;
+  };
+  bool stat_files(const std::vector<std::string>& file_paths, std::vector<FileStatus>& statuses);
+
+private:
+  int fd_;
+  bool is_statx_supported_;
+  void* sq_ring_;
+  std::size_t sq_ring_size_;
+  void* cq_ring_;
+  std::size_t cq_ring_size_;
+  io_uring_sqe* sqes_;
+  std::size_t sqes_size_;
+  unsigned* sq_tail_;
+  unsigned* sq_mask_;
+  unsigned* sq_array_;
+  unsigned* cq_head_;
+  unsigned* cq_tail_;
+  unsigned* cq_mask_;
+  io_uring_cqe* cqes_;
+  unsigned sq_entries_;
+  std::vector<struct statx> buffers_; /*!< Statx results of the submitted lookups */
+
+  void close_ring();
+  int enter(unsigned to_submit, unsigned min_complete);
+};
+
+/**
+ * \brief Set-up the io_uring instance, is_available() is false when the kernel doesn't support io_uring (or it is blocked)
+ */
+StatxRing::StatxRing()
+    : fd_(-1),
+      is_statx_supported_(true),
+      sq_ring_(MAP_FAILED),
+      sq_ring_size_(0),
+      cq_ring_(MAP_FAILED),
+      cq_ring_size_(0),
+      sqes_(static_cast<io_uring_sqe*>(MAP_FAILED)),
+      sqes_size_(0),
+      sq_tail_(nullptr),
+      sq_mask_(nullptr),
+      sq_array_(nullptr),
+      cq_head_(nullptr),
+      cq_tail_(nullptr),
+      cq_mask_(nullptr),
+      cqes_(nullptr),
+      sq_entries_(0)
+{
+  io_uring_params params;
+  std::memset(&params, 0, sizeof(params));
+  fd_ = static_cast<int>(syscall(__NR_io_uring_setup, RingEntries, &params));
+  if (fd_ < 0)
+    return;
+
+  sq_entries_ = params.sq_entries;
+  sq_ring_size_ = params.sq_off.array + params.sq_entries * sizeof(unsigned);
+  cq_ring_size_ = params.cq_off.cqes + params.cq_entries * sizeof(io_uring_cqe);
+  bool is_single_mmap = (params.features & IORING_FEAT_SINGLE_MMAP);
+  if (is_single_mmap)
+    sq_ring_size_ = cq_ring_size_ = std::max(sq_ring_size_, cq_ring_size_);
+
+  sq_ring_ = mmap(nullptr, sq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQ_RING);
+  if (sq_ring_ != MAP_FAILED)
+  {
+    cq_ring_ = (is_single_mmap) ? sq_ring_ : mmap(nullptr, cq_ring_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_CQ_RING);
+  }
+  if (cq_ring_ != MAP_FAILED)
+  {
+    sqes_size_ = params.sq_entries * sizeof(io_uring_sqe);
+    sqes_ = static_cast<io_uring_sqe*>(mmap(nullptr, sqes_size_, PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, fd_, IORING_OFF_SQES));
+  }
+  if (sqes_ == MAP_FAILED)
+  {
+    close_ring();
+    return;
+  }
+
+  char* sq_ring = static_cast<char*>(sq_ring_);
+  char* cq_ring = static_cast<char*>(cq_ring_);
+  sq_tail_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.tail);
+  sq_mask_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.ring_mask);
+  sq_array_ = reinterpret_cast<unsigned*>(sq_ring + params.sq_off.array);
+  cq_head_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.head);
+  cq_tail_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.tail);
+  cq_mask_ = reinterpret_cast<unsigned*>(cq_ring + params.cq_off.ring_mask);
+  cqes_ = reinterpret_cast<io_uring_cqe*>(cq_ring + params.cq_off.cqes);
+  buffers_.resize(sq_entries_);
+}
+
+/**
+ * \brief Destruct, the pending lookups are always completed at this point
+ */
+StatxRing::~StatxRing()
+{
+  close_ring();
+}
+
+/**
+ * \brief Unmap the rings and close the io_uring instance
+ */
+void StatxRing::close_ring()
+{
+  if (sqes_ != MAP_FAILED)
+    munmap(sqes_, sqes_size_);
+  if (cq_ring_ != MAP_FAILED && cq_ring_ != sq_ring_)
+    munmap(cq_ring_, cq_ring_size_);
+  if (sq_ring_ != MAP_FAILED)
+    munmap(sq_ring_, sq_ring_size_);
+  if (fd_ >= 0)
+    close(fd_);
+  sqes_ = static_cast<io_uring_sqe*>(MAP_FAILED);
+  cq_ring_ = sq_ring_ = MAP_FAILED;
+  fd_ = -1;
+}
+
+/**
+ * \brief Submit the queued lookups and/or wait for completed lookups
+ * \return Number of submitted lookups, or -1 on error (see errno)
+ */
+int StatxRing::enter(unsigned to_submit, unsigned min_complete)
+{
+  return static_cast<int>(syscall(__NR_io_uring_enter, fd_, to_submit, min_complete, IORING_ENTER_GETEVENTS, nullptr, 0));
+}
+
+/**
+ * \brief Retrieve the status of the files, in chunks of the ring size
+ * \param[in] file_paths File paths
+ * \param[out] statuses Status of each file, same order as the file paths
+ * \return false when io_uring could not be used (nothing is submitted), the caller should fall back to stat()
+ */
+bool StatxRing::stat_files(const std::vector<std::string>& file_paths, std::vector<FileStatus>& statuses)
+{
+  std::vector<std::size_t> unsupported;
+  for (std::size_t chunk_begin = 0; chunk_begin < file_paths.size(); chunk_begin += sq_entries_)
+  {
+    unsigned count = static_cast<unsigned>(std::min<std::size_t>(sq_entries_, file_paths.size() - chunk_begin));
+    // Single producer, the tail is only changed by this thread
+    unsigned tail = *sq_tail_;
+    for (unsigned i = 0; i < count; ++i)
+    {
+      unsigned sq_index = (tail + i) & *sq_mask_;
+      io_uring_sqe* sqe = &sqes_[sq_index];
+      std::memset(sqe, 0, sizeof(*sqe));
+      sqe->opcode = IORING_OP_STATX;
+      sqe->fd = AT_FDCWD;
+      sqe->addr = reinterpret_cast<std::uintptr_t>(file_paths[chunk_begin + i].c_str());
+      sqe->len = STATX_BASIC_STATS;
+      sqe->off = reinterpret_cast<std::uintptr_t>(&buffers_[i]);
+      sqe->statx_flags = 0; // Follow symlinks (eg. dosdevices/c:)
+      sqe->user_data = i;
+      sq_array_[sq_index] = sq_index;
+    }
+    std::atomic_ref<unsigned>(*sq_tail_).store(tail + count, std::memory_order_release);
+
+    unsigned to_submit = count;
+    unsigned completed = 0;
+    std::vector<bool> is_completed(count, false);
+    while (completed < count)
+    {
+      int submitted = enter(to_submit, count - completed);
+      if (submitted < 0)
+      {
+        if (errno == EINTR || errno == EAGAIN || errno == EBUSY)
+          continue;
+        if (to_submit == count)
+          std::atomic_ref<unsigned>(*sq_tail_).store(tail, std::memory_order_release); // Take back the queued lookups
+        // The ring is not used anymore, the lookups that are not completed are retrieved with stat()
+        close_ring();
+        if (chunk_begin == 0 && completed == 0)
+          return false;
+        for (std::size_t index = chunk_begin; index < file_paths.size(); ++index)
+        {
+          if (index >= chunk_begin + count || !is_completed[index - chunk_begin])
+            statuses[index] = BatchStat::stat_file(file_paths[index]);
+        }
+        return true;
+      }
+      to_submit -= std::min<unsigned>(to_submit, static_cast<unsigned>(submitted));
+
+      unsigned head = *cq_head_;
+      unsigned cq_tail = std::atomic_ref<unsigned>(*cq_tail_).load(std::memory_order_acquire);
+      for (; head != cq_tail; ++head, ++completed)
+      {
+        const io_uring_cqe& cqe = cqes_[head & *cq_mask_];
+        std::size_t index = chunk_begin + cqe.user_data;
+        is_completed[cqe.user_data] = true;
+        if (cqe.res == 0)
+        {
+          const struct statx& result = buffers_[cqe.user_data];
+          FileStatus& status = statuses[index];
+          status.exists = true;
+          status.mode = result.stx_mode;
+          status.size = static_cast<std::int64_t>(result.stx_size);
+          status.mtime_sec = result.stx_mtime.tv_sec;
+          status.mtime_nsec = result.stx_mtime.tv_nsec;
+        }
+        else if (cqe.res == -EINVAL)
+        {
+          // Kernels before 5.6 have io_uring, but don't support statx
+          unsupported.push_back(index);
+        }
+      }
+      std::atomic_ref<unsigned>(*cq_head_).store(head, std::memory_order_release);
+    }
+  }
+
+  if (!unsupported.empty())
+  {
+    is_statx_supported_ = false;
+    for (std::size_t index : unsupported)
+    {
+      statuses[index] = BatchStat::stat_file(file_paths[index]);
+    }
+  }
+  return true;
+}
+#endif
+
+/**
+ * \brief Retrieve the status of a single file with stat()
+ */
+static FileStatus stat_single_file(const std::string& file_path)
+{
+  FileStatus status;
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat) == 0)
+  {
+    status.exists = true;
+    status.mode = file_stat.st_mode;
+    status.size = file_stat.st_size;
+    status.mtime_sec = file_stat.st_mtim.tv_sec;
+    status.mtime_nsec = file_stat.st_mtim.tv_nsec;
+  }
+  return status;
+}
+
+bool FileStatus::is_directory() const
+{
+  return exists && S_ISDIR(mode);
+}
+
+bool FileStatus::is_regular_file() const
+{
+  return exists && S_ISREG(mode);
+}
+
+/**
+ * \brief Retrieve the status of all the files at once (symlinks are followed). Can be called from multiple threads at the same time.
+ * \param[in] file_paths File paths
+ * \return Status of each file, in the same order as the file paths
+ */
+std::vector<FileStatus> BatchStat::stat_files(const std::vector<std::string>& file_paths)
+{
+  std::vector<FileStatus> statuses(file_paths.size());
+  if (file_paths.empty())
+    return statuses;
+#ifdef HAVE_IO_URING_STATX
+  if (stat_files_io_uring(file_paths, statuses))
+    return statuses;
+#endif
+  stat_files_fallback(file_paths, statuses);
+  return statuses;
+}
+
+/**
+ * \brief Retrieve the status of a single file
+ * \param[in] file_path File path
+ * \return File status
+ */
+FileStatus BatchStat::stat_file(const std::string& file_path)
+{
+  return stat_single_file(file_path);
+}
+
+#ifdef HAVE_IO_URING_STATX
+/**
+ * \brief Retrieve the status of the files using the io_uring instance of this thread
+ * \return false when io_uring is not available
+ */
+bool BatchStat::stat_files_io_uring(const std::vector<std::string>& file_paths, std::vector<FileStatus>& statuses)
+{
+  thread_local StatxRing ring;
+  return ring.is_available() && ring.stat_files(file_paths, statuses);
+}
+#endif
+
+/**
+ * \brief Retrieve the status of the files with stat(), larger batches are divided over the fallback worker threads
+ */
+void BatchStat::stat_files_fallback(const std::vector<std::string>& file_paths, std::vector<FileStatus>& statuses)
+{
+  if (file_paths.size() <= FallbackChunkSize)
+  {
+    for (std::size_t i = 0; i < file_paths.size(); ++i)
+    {
+      statuses[i] = stat_single_file(file_paths[i]);
+    }
+    return;
+  }
+
+  static WorkerPool fallback_pool(FallbackThreads);
+  std::size_t chunk_count = (file_paths.size() + FallbackChunkSize - 1) / FallbackChunkSize;
+  std::latch done(static_cast<std::ptrdiff_t>(chunk_count));
+  for (std::size_t chunk_begin = 0; chunk_begin < file_paths.size(); chunk_begin += FallbackChunkSize)
+  {
+    fallback_pool.post([&file_paths, &statuses, &done, chunk_begin] {
+      std::size_t chunk_end = std::min(chunk_begin + FallbackChunkSize, file_paths.size());
+      for (std::size_t i = chunk_begin; i < chunk_end; ++i)
+      {
+        statuses[i] = stat_single_file(file_paths[i]);
+      }
+      done.count_down();
+    });
+  }
+  done.wait();
+}
@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    bottle_cache_file.cc
+ * \brief   Cache file of the Wine bottle details
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bottle_cache_file.h"
+#include "batch_stat.h"
+#include "bottle_types.h"
+#include <glibmm.h>
+#include <iostream>
+#include <sstream>
+
+static const int CacheVersion = 1; /*!< Increment when the stored fields are changed, older cache files are ignored */
+
+/**
+ * \brief Bottle files the details are retrieved from, a change of one of these files invalidates the cached details
+ */
+static const std::vector<std::string> StampedFiles = {"user.reg", "system.reg", ".update-timestamp", "winegui.ini", "dosdevices"};
+
+/**
+ * \brief Get the cache file location (~/.winegui/bottles_cache.ini)
+ * \return File path
+ */
+static std::string get_cache_file_path()
+{
+  std::vector<std::string> cache_dirs{Glib::get_home_dir(), ".winegui"};
+  std::string cache_location = Glib::build_path(G_DIR_SEPARATOR_S, cache_dirs);
+  return Glib::build_filename(cache_location, "bottles_cache.ini");
+}
+
+/// Meyers Singleton
+BottleCacheFile::BottleCacheFile() = default;
+/// Destructor
+BottleCacheFile::~BottleCacheFile() = default;
+
+/**
+ * \brief Get singleton instance
+ * \return BottleCacheFile reference (singleton)
+ */
+BottleCacheFile& BottleCacheFile::get_instance()
+{
+  static BottleCacheFile instance;
+  return instance;
+}
+
+/**
+ * \brief Write the bottle details cache file to disk
+ * \param entries Cached bottle details, by prefix path
+ * \return true if successfully written, otherwise false
+ */
+bool BottleCacheFile::write_cache_file(const std::map<std::string, BottleCacheEntry>& entries)
+{
+  bool success = false;
+  Glib::KeyFile keyfile;
+  try
+  {
+    keyfile.set_integer("General", "Version", CacheVersion);
+    for (int i = 0; const auto& [prefix_path, entry] : entries)
+    {
+      const BottleProbeData& data = entry.data;
+      std::string group_name = "Bottle." + std::to_string(i);
+      keyfile.set_string(group_name, "Prefix", prefix_path);
+      keyfile.set_string(group_name, "FileStamp", entry.file_stamp);
+      keyfile.set_string(group_name, "Name", data.name);
+      keyfile.set_string(group_name, "FolderName", data.folder_name);
+      keyfile.set_string(group_name, "Description", data.description);
+      keyfile.set_string(group_name, "VirtualDesktop", data.virtual_desktop);
+      keyfile.set_integer(group_name, "Bit", static_cast<int>(data.bit));
+      keyfile.set_string(group_name, "CDriveLocation", data.c_drive_location);
+      keyfile.set_string(group_name, "LastWineUpdated", data.last_time_wine_updated);
+      keyfile.set_integer(group_name, "AudioDriver", static_cast<int>(data.audio_driver));
+      keyfile.set_integer(group_name, "Windows", static_cast<int>(data.windows));
+      keyfile.set_boolean(group_name, "DebugLogging", data.debug_logging_enabled);
+      keyfile.set_integer(group_name, "DebugLogLevel", data.debug_log_level);
+      keyfile.set_boolean(group_name, "Status", data.status);
+      std::vector<Glib::ustring> app_names, app_descriptions, app_commands;
+      for (const auto& [index, app] : data.app_list)
+      {
+        app_names.push_back(app.name);
+        app_descriptions.push_back(app.description);
+        app_commands.push_back(app.command);
+      }
+      keyfile.set_string_list(group_name, "ApplicationNames", app_names);
+      keyfile.set_string_list(group_name, "ApplicationDescriptions", app_descriptions);
+      keyfile.set_string_list(group_name, "ApplicationCommands", app_commands);
+      i++;
+    }
+    success = keyfile.save_to_file(get_cache_file_path());
+  }
+  catch (const Glib::Error& ex)
+  {
+    std::cerr << "Error: Exception while saving the bottle cache file: " << ex.what() << std::endl;
+  }
+  return success;
+}
+
+/**
+ * \brief Read the bottle details cache file from disk
+ * \return Cached bottle details, by prefix path (empty when there is no valid cache file)
+ */
+std::map<std::string, BottleCacheEntry> BottleCacheFile::read_cache_file()
+{
+  std::map<std::string, BottleCacheEntry> entries;
+  std::string file_path = get_cache_file_path();
+  if (!Glib::file_test(file_path, Glib::FileTest::FILE_TEST_IS_REGULAR))
+    return entries;
+
+  Glib::KeyFile keyfile;
+  try
+  {
+    keyfile.load_from_file(file_path);
+    if (keyfile.get_integer("General", "Version") != CacheVersion)
+      return entries;
+
+    for (const Glib::ustring& group : keyfile.get_groups())
+    {
+      if (!std::string(group).starts_with("Bottle."))
+        continue;
+
+      int bit = keyfile.get_integer(group, "Bit");
+      int audio_driver = keyfile.get_integer(group, "AudioDriver");
+      int windows = keyfile.get_integer(group, "Windows");
+      // Skip invalid entries, those bottles are retrieved again
+      if (bit < 0 || bit > static_cast<int>(BottleTypes::Bit::win64) || audio_driver < BottleTypes::AudioDriverStart ||
+          audio_driver >= BottleTypes::AudioDriverEnd || windows < 0 || windows >= static_cast<int>(BottleTypes::WindowsEnumSize))
+        continue;
+
+      BottleCacheEntry entry;
+      BottleProbeData& data = entry.data;
+      entry.file_stamp = keyfile.get_string(group, "FileStamp");
+      data.name = keyfile.get_string(group, "Name");
+      data.folder_name = keyfile.get_string(group, "FolderName");
+      data.description = keyfile.get_string(group, "Description");
+      data.virtual_desktop = keyfile.get_string(group, "VirtualDesktop");
+      data.bit = static_cast<BottleTypes::Bit>(bit);
+      data.c_drive_location = keyfile.get_string(group, "CDriveLocation");
+      data.last_time_wine_updated = keyfile.get_string(group, "LastWineUpdated");
+      data.audio_driver = static_cast<BottleTypes::AudioDriver>(audio_driver);
+      data.windows = static_cast<BottleTypes::Windows>(windows);
+      data.debug_logging_enabled = keyfile.get_boolean(group, "DebugLogging");
+      data.debug_log_level = keyfile.get_integer(group, "DebugLogLevel");
+      data.status = keyfile.get_boolean(group, "Status");
+      std::vector<Glib::ustring> app_names = keyfile.get_string_list(group, "ApplicationNames");
+      std::vector<Glib::ustring> app_descriptions = keyfile.get_string_list(group, "ApplicationDescriptions");
+      std::vector<Glib::ustring> app_commands = keyfile.get_string_list(group, "ApplicationCommands");
+      if (app_descriptions.size() != app_names.size() || app_commands.size() != app_names.size())
+        continue;
+      for (std::size_t i = 0; i < app_names.size(); ++i)
+      {
+        data.app_list.insert(std::pair<int, ApplicationData>(i, {app_names.at(i), app_descriptions.at(i), app_commands.at(i)}));
+      }
+      entries.insert_or_assign(keyfile.get_string(group, "Prefix"), std::move(entry));
+    }
+  }
+  catch (const Glib::Error& ex)
+  {
+    std::cerr << "Error: Exception while loading the bottle cache file: " << ex.what() << std::endl;
+    // All bottles are retrieved again, the cache file is written again afterwards
+    entries.clear();
+  }
+  return entries;
+}
+
+/**
+ * \brief Get the file stamp of a bottle: the modification time and size of the bottle files (only the status is retrieved, no file is opened)
+ * \param prefix_path Wine prefix path
+ * \return File stamp
+ */
+std::string BottleCacheFile::get_file_stamp(const std::string& prefix_path)
+{
+  std::vector<std::string> file_paths;
+  file_paths.reserve(StampedFiles.size());
+  for (const std::string& file_name : StampedFiles)
+  {
+    file_paths.push_back(Glib::build_filename(prefix_path, file_name));
+  }
+  // All the files are looked up at once
+  std::ostringstream stamp;
+  for (const FileStatus& status : BatchStat::stat_files(file_paths))
+  {
+    if (status.exists)
+      stamp << status.mtime_sec << "." << status.mtime_nsec << ":" << status.size << ";";
+    else
+      stamp << "-;"; // Missing file
+  }
+  return stamp.str();
+}
@@ -43,7 +43,8 @@ BottleEditWindow::BottleEditWindow(Gtk::Window& parent)
       cancel_button("Cancel"),
       delete_button("Delete Machine"),
       busy_dialog(*this),
-      active_bottle_(nullptr)
+      active_bottle_(nullptr),
+      operation_id_(0)
 {
   set_transient_for(parent);
   set_default_size(500, 500);
@@ -249,10 +250,14 @@ void BottleEditWindow::bottle_removed()
 }
 
 /**
- * \brief Handler when the bottle is updated.
+ * \brief Handler when a bottle is updated or failed to update.
+ * \param[in] operation_id Operation number of the update
  */
-void BottleEditWindow::on_bottle_updated()
+void BottleEditWindow::on_bottle_updated(std::size_t operation_id)
 {
+  // Keep busy until the update of the last save is finished
+  if (operation_id != operation_id_)
+    return;
   busy_dialog.hide();
   hide(); // Close the edit Window
 }
@@ -315,6 +320,7 @@ void BottleEditWindow::on_save_button_clicked()
   update_bottle_struct.audio = WineDefaults::AudioDriver;         // Fallback
   update_bottle_struct.virtual_desktop_resolution = "";           // Empty string default (= disabled windowed mode)
   update_bottle_struct.debug_log_level = 1;                       // // 1 = Default wine debug logging
+  update_bottle_struct.operation_id = ++operation_id_;
 
   // First disable save button (avoid multiple presses)
   save_button.set_sensitive(false);
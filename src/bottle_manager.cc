@@ -21,16 +21,60 @@
 #include "bottle_manager.h"
 #include "bottle_config_file.h"
 #include "bottle_item.h"
+#include "bottle_probe.h"
+#include "disk_usage.h"
 #include "dll_override_types.h"
 #include "general_config_file.h"
 #include "helper.h"
+#include "log_sink.h"
 #include "main_window.h"
 #include "signal_controller.h"
 #include "wine_defaults.h"
 
+#include <algorithm>
 #include <chrono>
+#include <set>
 #include <stdexcept>
 
+static const unsigned int RefreshTimeout = 500; /*!< Time in ms to wait for more file changes, before the bottles are refreshed */
+static const unsigned int JobThreads = 4;       /*!< Maximum number of bottles changed at the same time (eg. installs) */
+static const unsigned int DiskUsageThreads = 4; /*!< Directory walks are I/O bound, a few threads are enough to keep the disk busy */
+static const unsigned int ScanThreads = 4;      /*!< Bottle locations scanned at the same time, a slow disk only delays its own location */
+static const std::set<string> WatchedBottleFiles = {"user.reg", "system.reg", "winegui.ini", ".update-timestamp"}; /*!< Files in a bottle prefix */
+
+/**
+ * \brief Install a package by running the program (in a job thread).
+ * The finish dispatcher is always emitted, so the busy dialog is closed again when the program can't be run.
+ * \param[in] wine_prefix The path to wine bottle
+ * \param[in] debug_log_level Debug log level
+ * \param[in] program Program that gets executed
+ * \param[in] debug_logging Write the program output to the bottle log file
+ * \param[in] logging_stderr Also output stderr (together with stout)
+ * \param[in] finish_dispatcher Dispatcher that is emitted when the install is finished
+ */
+static void run_install_program(const string& wine_prefix,
+                                int debug_log_level,
+                                const string& program,
+                                bool debug_logging,
+                                bool logging_stderr,
+                                Glib::Dispatcher& finish_dispatcher)
+{
+  try
+  {
+    LogSink log_sink(Helper::get_log_file_path(wine_prefix), debug_logging);
+    Helper::run_program(wine_prefix, debug_log_level, program, log_sink, true, logging_stderr);
+    Helper::wait_until_wineserver_is_terminated(wine_prefix);
+  }
+  catch (...)
+  {
+    // Inform the user, the job is marked as failed as well
+    Helper::get_instance().failure_on_exec.emit();
+    finish_dispatcher.emit();
+    throw;
+  }
+  finish_dispatcher.emit();
+}
+
 /*************************************************************
  * Public member functions                                   *
  *************************************************************/
@@ -40,17 +84,29 @@
  * \param main_window Address to the main Window
  */
 BottleManager::BottleManager(MainWindow& main_window)
-    : error_message_mutex_(),
-      output_loging_mutex_(),
-      main_window_(main_window),
+    : main_window_(main_window),
+      bottle_scan_depth_(1),
+      wine_version_(nullptr),
       active_bottle_(nullptr),
       is_wine64_bit_(false),
       is_logging_stderr_(true),
-      error_message_()
+      probe_generation_(0),
+      probe_sequence_(0),
+      pending_probes_(0),
+      is_bottle_cache_changed_(false),
+      scan_generation_(0),
+      is_scan_applied_(false),
+      is_bottle_location_changed_(false),
+      job_scheduler_(JobThreads, [this] { jobs_changed_dispatcher_.emit(); }),
+      scan_pool_(ScanThreads),
+      disk_usage_pool_(DiskUsageThreads)
 {
   // Connect internal dispatcher(s)
-  update_bottles_dispatcher_.connect(sigc::bind(sigc::mem_fun(this, &BottleManager::update_config_and_bottles), false));
-  write_log_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::write_log_to_file));
+  update_bottles_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::update_config_and_bottles));
+  scan_finished_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::on_bottle_paths_found));
+  probe_finished_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::on_bottle_details_retrieved));
+  disk_usage_dispatcher_.connect(sigc::mem_fun(this, &BottleManager::on_disk_usage_retrieved));
+  jobs_changed_dispatcher_.connect(jobs_changed.make_slot());
 }
 
 /**
@@ -58,6 +114,11 @@ BottleManager::BottleManager(MainWindow& main_window)
  */
 BottleManager::~BottleManager()
 {
+  refresh_timeout_.disconnect();
+  // Do not wait for bottle locations and bottle details that are not retrieved yet
+  scan_pool_.cancel_pending();
+  probe_pool_.cancel_pending();
+  disk_usage_pool_.cancel_pending();
 }
 
 /**
@@ -95,54 +156,204 @@ void BottleManager::prepare()
     }
   }
 
+  // Unchanged bottles are restored from the cache file, instead of retrieving the details again
+  bottle_cache_ = BottleCacheFile::read_cache_file();
+
   // Start the initial read from disk to fetch the bottles & update GUI
-  // true - during startup
-  update_config_and_bottles(true);
+  update_config_and_bottles();
 }
 
 /**
- * \brief Write debugging logging to file handler
+ * \brief Apply the retrieved bottle details to the bottles (signal handler, in GUI thread)
  */
-void BottleManager::write_log_to_file()
+void BottleManager::on_bottle_details_retrieved()
 {
-  std::lock_guard<std::mutex> lock(error_message_mutex_);
-  char last_char = output_logging_.back();
-  // Needs new line at end of string?
-  if (last_char != '\n')
+  std::vector<ProbeResult> results;
   {
-    output_logging_ += '\n';
+    std::lock_guard<std::mutex> lock(probe_results_mutex_);
+    results.swap(probe_results_);
+  }
+  for (const ProbeResult& result : results)
+  {
+    // Skip results of a previous refresh (checked each time, the error dialog below runs the main loop)
+    if (result.generation != probe_generation_)
+      continue;
+    --pending_probes_;
+    // Skip results of removed bottles and outdated results, the bottle details are retrieved again in the meantime
+    auto found = record_index_.find(result.prefix_path);
+    auto latest = latest_probes_.find(result.prefix_path);
+    if (found == record_index_.end() || latest == latest_probes_.end() || result.sequence != latest->second)
+    {
+      if (pending_probes_ == 0)
+        save_bottle_cache();
+      continue;
+    }
+
+    std::size_t index = found->second;
+    const BottleProbeData& probe = result.data;
+    BottleRecord& record = records_.at(index);
+    record.name = probe.name;
+    record.description = probe.description;
+    record.status = probe.status;
+    record.windows = probe.windows;
+    record.bit = probe.bit;
+    record.c_drive_location = probe.c_drive_location;
+    record.last_time_wine_updated = probe.last_time_wine_updated;
+    record.audio_driver = probe.audio_driver;
+    record.virtual_desktop = probe.virtual_desktop;
+    record.debug_logging_enabled = probe.debug_logging_enabled;
+    record.debug_log_level = probe.debug_log_level;
+    record.app_list = probe.app_list;
+    record.is_loading = false;
+    main_window_.update_bottle(*bottle_rows_.at(index));
+
+    // Only complete details are cached, so the warnings are shown again next time
+    if (!result.is_from_cache)
+    {
+      if (probe.warnings.empty())
+        bottle_cache_.insert_or_assign(record.prefix_path, BottleCacheEntry{result.file_stamp, probe});
+      else
+        bottle_cache_.erase(record.prefix_path);
+      is_bottle_cache_changed_ = true;
+    }
+    if (pending_probes_ == 0)
+      save_bottle_cache();
+
+    for (const string& warning : probe.warnings)
+    {
+      main_window_.show_error_message(warning);
+    }
   }
-  Helper::write_to_log_file(logging_bottle_prefix_, output_logging_);
 }
 
 /**
- * \brief Update WineGUI Config and update bottles by reading the Wine Bottles from disk and update GUI
- * \param is_startup Set to true if this function is called during start-up, otherwise false
+ * \brief Signal handler when the disk usage of bottles is calculated (in the worker threads)
  */
-void BottleManager::update_config_and_bottles(bool is_startup)
+void BottleManager::on_disk_usage_retrieved()
 {
-  // Read general & save config in bottle manager
-  GeneralConfigData config_data = load_and_save_general_config();
-  // Set/update main window about the latest general config data
-  main_window_.set_general_config(config_data);
+  std::vector<DiskUsageResult> results;
+  {
+    std::lock_guard<std::mutex> lock(disk_usage_results_mutex_);
+    results.swap(disk_usage_results_);
+  }
+  for (const DiskUsageResult& result : results)
+  {
+    // Skip results of a previous refresh and of removed bottles
+    auto found = record_index_.find(result.prefix_path);
+    if (result.generation != probe_generation_ || found == record_index_.end())
+      continue;
+    BottleRecord& record = records_.at(found->second);
+    record.disk_usage = result.disk_usage;
+    record.is_disk_usage_loading = false;
+    main_window_.update_bottle(*bottle_rows_.at(found->second));
+  }
+}
+
+/**
+ * \brief Signal handler when a file in the bottle location is changed, a bottle may be added or removed
+ */
+void BottleManager::on_bottle_location_changed(const Glib::RefPtr<Gio::File>&, const Glib::RefPtr<Gio::File>&, Gio::FileMonitorEvent event)
+{
+  switch (event)
+  {
+  case Gio::FILE_MONITOR_EVENT_CREATED:
+  case Gio::FILE_MONITOR_EVENT_DELETED:
+  case Gio::FILE_MONITOR_EVENT_MOVED:
+  case Gio::FILE_MONITOR_EVENT_RENAMED:
+  case Gio::FILE_MONITOR_EVENT_MOVED_IN:
+  case Gio::FILE_MONITOR_EVENT_MOVED_OUT:
+    is_bottle_location_changed_ = true;
+    schedule_refresh();
+    break;
+  default:
+    break;
+  }
+}
 
-  bool try_to_restore = (active_bottle_ != nullptr);
-  if (try_to_restore)
+/**
+ * \brief Signal handler when a file in a bottle prefix is changed, only changes of the bottle files are handled
+ * \param[in] file         Changed file
+ * \param[in] other_file   New file name (in case of a rename)
+ * \param[in] event        Type of change
+ * \param[in] prefix_path  Bottle prefix
+ */
+void BottleManager::on_prefix_changed(const Glib::RefPtr<Gio::File>& file,
+                                      const Glib::RefPtr<Gio::File>& other_file,
+                                      Gio::FileMonitorEvent event,
+                                      const string& prefix_path)
+{
+  if (event == Gio::FILE_MONITOR_EVENT_ATTRIBUTE_CHANGED)
+    return;
+  bool is_bottle_file = (file && WatchedBottleFiles.contains(file->get_basename())) ||
+                        (other_file && WatchedBottleFiles.contains(other_file->get_basename()));
+  if (is_bottle_file)
+  {
+    changed_prefixes_.insert(prefix_path);
+    schedule_refresh();
+  }
+}
+
+/**
+ * \brief Signal handler when the refresh timeout is expired, handles all the file changes since the timeout was started
+ * \return false, so the timeout is stopped
+ */
+bool BottleManager::on_refresh_timeout()
+{
+  if (is_bottle_location_changed_)
+  {
+    // Adds/removes the changed bottles, the details of the other bottles are retrieved again (from the cache when unchanged)
+    update_config_and_bottles();
+  }
+  else
+  {
+    // Only retrieve the details of the changed bottles again
+    for (const string& prefix_path : changed_prefixes_)
+    {
+      auto changed = record_index_.find(prefix_path);
+      if (changed != record_index_.end())
+      {
+        retrieve_bottle_details(changed->second);
+        retrieve_disk_usage(changed->second);
+      }
+    }
+  }
+  is_bottle_location_changed_ = false;
+  changed_prefixes_.clear();
+  return false;
+}
+
+/**
+ * \brief Write the bottle details cache file (when changed), after all the bottles are loaded.
+ * Bottles that are removed in the meantime are removed from the cache as well.
+ */
+void BottleManager::save_bottle_cache()
+{
+  std::erase_if(bottle_cache_, [this](const auto& entry) {
+    bool is_removed = !record_index_.contains(entry.first);
+    is_bottle_cache_changed_ |= is_removed;
+    return is_removed;
+  });
+  if (is_bottle_cache_changed_)
   {
-    previous_active_bottle_index_ = active_bottle_->get_index();
-    // Save the current bottle list size
-    previous_bottles_list_size_ = bottles_.size();
+    BottleCacheFile::write_cache_file(bottle_cache_);
+    is_bottle_cache_changed_ = false;
   }
+}
 
-  // Clear bottles
-  if (!bottles_.empty())
-    bottles_.clear();
+/**
+ * \brief Update WineGUI Config and update bottles by reading the Wine Bottles from disk and update GUI.
+ * The bottle locations are scanned in the background, the bottle list is updated as soon as a location is scanned.
+ */
+void BottleManager::update_config_and_bottles()
+{
+  // Read general & save config in bottle manager
+  GeneralConfigData config_data = load_and_save_general_config();
+  // Set/update main window about the latest general config data
+  main_window_.set_general_config(config_data);
 
-  // Get the bottle directories
-  std::vector<string> bottle_dirs;
   try
   {
-    bottle_dirs = get_bottle_paths();
+    create_bottle_location();
   }
   catch (const std::runtime_error& error)
   {
@@ -150,56 +361,147 @@ void BottleManager::update_config_and_bottles(bool is_startup)
     return; // stop
   }
 
-  if (bottle_dirs.size() > 0)
+  Glib::ustring wine_version = get_wine_version();
+  wine_version_ = &(*wine_versions_.insert(wine_version).first);
+
+  scan_bottle_locations();
+}
+
+/**
+ * \brief Apply the found bottle directories of the scanned bottle locations (signal handler, in GUI thread)
+ */
+void BottleManager::on_bottle_paths_found()
+{
+  std::vector<ScanResult> results;
   {
-    try
+    std::lock_guard<std::mutex> lock(scan_results_mutex_);
+    results.swap(scan_results_);
+  }
+
+  bool is_changed = false;
+  for (ScanResult& result : results)
+  {
+    // Bottle locations of a previous scan are ignored
+    if (result.generation != scan_generation_)
+      continue;
+    scanned_paths_.at(result.index) = std::move(result.paths);
+    is_changed = true;
+  }
+  if (is_changed)
+  {
+    // The details of the existing bottles are only retrieved again for the first location of a scan
+    set_bottle_paths(Helper::merge_bottles_paths(scanned_paths_, is_display_default_wine_machine_), !is_scan_applied_);
+    is_scan_applied_ = true;
+  }
+}
+
+/**
+ * \brief Update the bottle list and the GUI to the bottle directories.
+ * Only the rows of added and removed bottles are changed, the details of the other bottles are updated in place.
+ * \param[in] bottle_dirs Bottle directories, in the order of the bottle list
+ * \param[in] is_refresh Retrieve the details of all bottles again, otherwise only of the added bottles
+ */
+void BottleManager::set_bottle_paths(const std::vector<string>& bottle_dirs, bool is_refresh)
+{
+  // Selection is restored by prefix path
+  string previous_active_prefix = (active_bottle_ != nullptr) ? string(active_bottle_->wine_location()) : "";
+
+  if (is_refresh)
+  {
+    // Bottle details that are still being retrieved are ignored from now on
+    ++probe_generation_;
+    probe_pool_.cancel_pending();
+    disk_usage_pool_.cancel_pending();
+  }
+
+  std::map<string, std::list<BottleItem>::iterator> current_rows;
+  for (auto it = bottles_.begin(); it != bottles_.end(); ++it)
+  {
+    current_rows.emplace(it->wine_location(), it);
+  }
+
+  // Bottle records in the same (sorted) order as the bottle directories, the records of the existing bottles are moved
+  std::vector<BottleRecord> records;
+  std::map<string, std::size_t> record_index;
+  std::vector<std::size_t> added_records;
+  records.reserve(bottle_dirs.size());
+  for (const string& prefix : bottle_dirs)
+  {
+    auto existing = record_index_.find(prefix);
+    if (existing != record_index_.end())
     {
-      // Create wine bottles from bottle directories and wine version
-      bottles_ = create_wine_bottles(bottle_dirs);
+      records.push_back(std::move(records_.at(existing->second)));
     }
-    catch (const std::runtime_error& error)
+    else
     {
-      main_window_.show_error_message(error.what());
-      return; // stop
+      // Only the folder name is known, the bottle details are retrieved later by retrieve_bottle_details()
+      BottleRecord record;
+      record.prefix_path = prefix;
+      record.folder_name = Helper::get_folder_name(prefix);
+      records.push_back(std::move(record));
+      added_records.push_back(records.size() - 1);
     }
+    records.back().wine_version = wine_version_;
+    records.back().is_wine64_bit = is_wine64_bit_;
+    record_index.emplace(prefix, records.size() - 1);
+  }
 
-    if (!bottles_.empty())
+  // Rows are only build for the added bottles. Splicing keeps the existing rows alive, the rows of the removed bottles are left behind.
+  std::list<BottleItem> bottles;
+  bottle_rows_.clear();
+  for (const BottleRecord& record : records)
+  {
+    auto current = current_rows.find(record.prefix_path);
+    if (current != current_rows.end())
     {
-      // Update main Window
-      main_window_.set_wine_bottles(bottles_);
-
-      // Is try to store boolean true?
-      // And: Is the bottle list size the same?
-      // And: Is the previous index not bigger than the list size?
-      if (try_to_restore && (bottles_.size() == previous_bottles_list_size_) && ((size_t)previous_active_bottle_index_ < bottles_.size()))
-      {
-        // Let's reset the previous state!
-        auto front = bottles_.begin();
-        std::advance(front, previous_active_bottle_index_);
-        main_window_.select_row_bottle(*front);
-        // Set active bottle at the previous index
-        active_bottle_ = &(*front);
-      }
-      else
-      {
-        // Bottle list is changed, let's set the first bottle in the detailed info panel.
-        // begin() gives us an iterator with the first element
-        auto first = bottles_.begin();
-        // Trigger select row, except during start-up (show_all will auto-select the first listbox item in GTK)
-        if (!is_startup)
-          main_window_.select_row_bottle(*first);
-        // Set active bottle at the first
-        active_bottle_ = &(*first);
-      }
+      bottles.splice(bottles.end(), bottles_, current->second);
+      bottles.back().record(record);
     }
     else
     {
-      main_window_.show_error_message("Could not create an overview of Windows Machines. Empty list.");
+      bottles.emplace_back(record);
+    }
+    bottle_rows_.push_back(&bottles.back());
+  }
+  records_.swap(records);
+  record_index_.swap(record_index);
+  bottles_.swap(bottles);
+  // Update main Window, rows of the removed bottles (still in bottles) are removed
+  main_window_.set_wine_bottles(bottles_);
+  bottles.clear();
+  update_file_monitors();
+  // Probes of the removed bottles are ignored, the pending count still includes them until their results arrive
+  std::erase_if(latest_probes_, [this](const auto& latest) { return !record_index_.contains(latest.first); });
+
+  if (is_refresh)
+  {
+    retrieve_bottle_details();
+    retrieve_disk_usage();
+  }
+  else
+  {
+    for (std::size_t index : added_records)
+    {
+      retrieve_bottle_details(index);
+      retrieve_disk_usage(index);
+    }
+  }
 
-      // Send reset signal to reset the active bottle to NULL
-      reset_active_bottle.emit();
-      // Reset locally
-      active_bottle_ = nullptr;
+  if (!records_.empty())
+  {
+    auto active = record_index_.find(previous_active_prefix);
+    if (active != record_index_.end())
+    {
+      // Let's restore the previous state!
+      active_bottle_ = bottle_rows_.at(active->second);
+      main_window_.select_row_bottle(*active_bottle_);
+    }
+    else
+    {
+      // Bottle list is changed, let's set the first bottle in the detailed info panel.
+      // Always trigger select row, the bottle list is only set after the main window is shown
+      active_bottle_ = bottle_rows_.front();
+      main_window_.select_row_bottle(*active_bottle_);
     }
   }
   else
@@ -212,8 +514,10 @@ void BottleManager::update_config_and_bottles(bool is_startup)
 }
 
 /**
- * \brief Create a new Wine Bottle (runs in thread!)
- * \param[in] caller                      - Signal Dispatcher pointer, in order to signal back events
+ * \brief Create a new Wine Bottle, in a job. Operations on different bottles run in parallel,
+ * operations on the same bottle run one after the other.
+ * \param[in] caller                      - Signal Dispatcher pointer, in order to signal back events (from the job thread)
+ * \param[in] operation_id                - Operation number, passed back to the caller
  * \param[in] name                        - Bottle Name
  * \param[in] windows_version             - Windows OS version
  * \param[in] bit                         - Windows Bit (32/64-bit)
@@ -222,6 +526,7 @@ void BottleManager::update_config_and_bottles(bool is_startup)
  * \param[in] audio                       - Audio Driver type
  */
 void BottleManager::new_bottle(SignalController* caller,
+                               std::size_t operation_id,
                                const Glib::ustring& name,
                                BottleTypes::Windows windows_version,
                                BottleTypes::Bit bit,
@@ -229,122 +534,47 @@ void BottleManager::new_bottle(SignalController* caller,
                                bool disable_gecko_mono,
                                BottleTypes::AudioDriver audio)
 {
-  // First check if wine is installed
-  int wineStatus = Helper::determine_wine_executable();
-  if (wineStatus == -1)
-  {
-    {
-      std::lock_guard<std::mutex> lock(error_message_mutex_);
-      error_message_ = "Could not find wine binary. Please first install wine on your machine.";
-    }
-    caller->signal_error_message_during_create();
-    return; // Stop thread prematurely
-  }
-
   // Build prefix
   // Name of the bottle we be used as folder name as well
   std::vector<string> dirs{bottle_location_, name};
   string prefix_path = Glib::build_path(G_DIR_SEPARATOR_S, dirs);
-  bool bottle_created = false;
-  try
   {
-    // Now create a new Wine Bottle
-    Helper::create_wine_bottle(is_wine64_bit_, prefix_path, bit, disable_gecko_mono);
-    // Create default Bottle config data struct
-    BottleConfigData bottle_config;
-    bottle_config.name = name;
-    bottle_config.description = "";        // By default empty description
-    bottle_config.logging_enabled = false; // By default disable logging
-    bottle_config.debug_log_level = 1;     // 1 (default) = Normal debug log level
-    // Create empty custom app list
-    std::map<int, ApplicationData> app_list;
-    // Next, write the WineGUI bottle config file
-    if (!BottleConfigFile::write_config_file(prefix_path, bottle_config, app_list))
+    // Another bottle is renamed to the same folder name
+    std::lock_guard<std::mutex> lock(rename_destinations_mutex_);
+    if (rename_destinations_.contains(prefix_path))
     {
-      // TODO: Maybe a warning message to the user?
-      // No critical failure, only log an error to console.
-      std::cout << "Error: Could not write bottle config file." << std::endl;
+      caller->signal_error_message_during_create(operation_id, "A machine is being renamed to the same folder name:\n" + prefix_path);
+      return;
     }
-    bottle_created = true;
   }
-  catch (const std::runtime_error& error)
-  {
+  job_scheduler_.post(prefix_path, "Create machine", [caller, operation_id, prefix_path, wine64 = is_wine64_bit_, name, windows_version, bit,
+                                                      virtual_desktop_resolution, disable_gecko_mono, audio] {
+    try
     {
-      std::lock_guard<std::mutex> lock(error_message_mutex_);
-      error_message_ = ("Something went wrong during creation of a new Windows machine!\n" + Glib::ustring(error.what()));
+      create_bottle(wine64, prefix_path, name, windows_version, bit, virtual_desktop_resolution, disable_gecko_mono, audio);
+      caller->signal_bottle_created(operation_id);
     }
-    caller->signal_error_message_during_create();
-    return; // Stop thread prematurely
-  }
-
-  // Continue with additional settings
-  if (bottle_created)
-  {
-    // Only change Windows OS when NOT default
-    if (windows_version != WineDefaults::WindowsOs)
+    catch (const std::exception& error)
     {
-      try
-      {
-        Helper::set_windows_version(prefix_path, windows_version);
-      }
-      catch (const std::runtime_error& error)
-      {
-        {
-          std::lock_guard<std::mutex> lock(error_message_mutex_);
-          error_message_ = ("Something went wrong during setting another Windows version.\n" + Glib::ustring(error.what()));
-        }
-        caller->signal_error_message_during_create();
-        return; // Stop thread prematurely
-      }
+      caller->signal_error_message_during_create(operation_id, error.what());
     }
-
-    // Only if virtual desktop is not empty, enable it
-    if (!virtual_desktop_resolution.empty())
+    catch (const Glib::Error& error)
     {
-      try
-      {
-        Helper::set_virtual_desktop(prefix_path, virtual_desktop_resolution);
-      }
-      catch (const std::runtime_error& error)
-      {
-        {
-          std::lock_guard<std::mutex> lock(error_message_mutex_);
-          error_message_ = ("Something went wrong during enabling virtual desktop mode.\n" + Glib::ustring(error.what()));
-        }
-        caller->signal_error_message_during_create();
-        return; // Stop thread prematurely
-      }
+      caller->signal_error_message_during_create(operation_id, error.what());
     }
-
-    // Only if Audio driver is not default, change it
-    if (audio != WineDefaults::AudioDriver)
+    catch (...)
     {
-      try
-      {
-        Helper::set_audio_driver(prefix_path, audio);
-      }
-      catch (const std::runtime_error& error)
-      {
-        {
-          std::lock_guard<std::mutex> lock(error_message_mutex_);
-          error_message_ = ("Something went wrong during setting another audio driver.\n" + Glib::ustring(error.what()));
-        }
-        caller->signal_error_message_during_create();
-        return; // Stop thread prematurely
-      }
+      // Always signal the result, the dialog is busy until then
+      caller->signal_error_message_during_create(operation_id, "Unknown error");
     }
-  }
-
-  // Wait until wineserver terminates
-  Helper::wait_until_wineserver_is_terminated(prefix_path);
-
-  // Trigger done signal
-  caller->signal_bottle_created();
+  });
 }
 
 /**
- * \brief Update existing Wine bottle (runs in thread)
- * \param[in] caller                      Signal Dispatcher pointer, in order to signal back events
+ * \brief Update the active Wine bottle, in a job. Operations on different bottles run in parallel,
+ * operations on the same bottle run one after the other.
+ * \param[in] caller                      Signal Dispatcher pointer, in order to signal back events (from the job thread)
+ * \param[in] operation_id                Operation number, passed back to the caller
  * \param[in] name                        Bottle Name
  * \param[in] folder_name                 Bottle Folder Name
  * \param[in] description                 Description text
@@ -355,6 +585,7 @@ void BottleManager::new_bottle(SignalController* caller,
  * \param[in] debug_log_level             Bottle Debug Log Level
  */
 void BottleManager::update_bottle(SignalController* caller,
+                                  std::size_t operation_id,
                                   const Glib::ustring& name,
                                   const Glib::ustring& folder_name,
                                   const Glib::ustring& description,
@@ -364,150 +595,56 @@ void BottleManager::update_bottle(SignalController* caller,
                                   bool is_debug_logging,
                                   int debug_log_level)
 {
-  if (active_bottle_ != nullptr)
+  if (active_bottle_ == nullptr)
   {
-    string prefix_path = active_bottle_->wine_location();
-
-    bool need_update_bottle_config_file = false;
-    BottleConfigData bottle_config;
-    std::map<int, ApplicationData> app_list; // App list is never dirty, so no need to check
-    std::tie(bottle_config, app_list) = BottleConfigFile::read_config_file(prefix_path);
-    if (active_bottle_->name() != name)
-    {
-      bottle_config.name = name;
-      need_update_bottle_config_file = true;
-    }
-    if (active_bottle_->description() != description)
-    {
-      bottle_config.description = description;
-      need_update_bottle_config_file = true;
-    }
-    if (active_bottle_->is_debug_logging() != is_debug_logging)
+    caller->signal_error_message_during_update(operation_id, "No current Windows Machine was set?");
+    return;
+  }
+  // Only the prefix is taken, the active bottle can change in the meantime
+  string prefix_path = active_bottle_->wine_location();
+  string new_prefix_path;
+  if (folder_name != Helper::get_folder_name(prefix_path))
+  {
+    // The new prefix is reserved until the job is finished, a new bottle with the same folder name is rejected in the meantime.
+    // The job only runs after the jobs of the current prefix, so a create of the new prefix that is already posted is rejected here.
+    std::vector<string> dirs{Glib::path_get_dirname(prefix_path), folder_name};
+    new_prefix_path = Glib::build_path(G_DIR_SEPARATOR_S, dirs);
+    std::lock_guard<std::mutex> lock(rename_destinations_mutex_);
+    if (Helper::dir_exists(new_prefix_path) || job_scheduler_.is_busy(new_prefix_path) || rename_destinations_.contains(new_prefix_path))
     {
-      bottle_config.logging_enabled = is_debug_logging;
-      need_update_bottle_config_file = true;
+      caller->signal_error_message_during_update(operation_id, "The folder name is already used (or being created):\n" + new_prefix_path);
+      return;
     }
-    if (active_bottle_->debug_log_level() != debug_log_level)
+    rename_destinations_.insert(new_prefix_path);
+  }
+  job_scheduler_.post(prefix_path, "Change settings", [this, caller, prefix_path, new_prefix_path, wine64 = is_wine64_bit_, name, folder_name,
+                                                       description, windows_version, operation_id, virtual_desktop_resolution, audio,
+                                                       is_debug_logging, debug_log_level] {
+    try
     {
-      bottle_config.debug_log_level = debug_log_level;
-      need_update_bottle_config_file = true;
+      change_bottle(wine64, prefix_path, name, folder_name, description, windows_version, virtual_desktop_resolution, audio, is_debug_logging,
+                    debug_log_level);
+      caller->signal_bottle_updated(operation_id);
     }
-
-    if (need_update_bottle_config_file)
+    catch (const std::exception& error)
     {
-      if (!BottleConfigFile::write_config_file(prefix_path, bottle_config, app_list))
-      {
-        // Silent error
-        std::cout << "Error: Could not update bottle config file." << std::endl;
-      }
+      caller->signal_error_message_during_update(operation_id, error.what());
     }
-
-    if (active_bottle_->windows() != windows_version)
+    catch (const Glib::Error& error)
     {
-      try
-      {
-        Helper::set_windows_version(prefix_path, windows_version);
-      }
-      catch (const std::runtime_error& error)
-      {
-        {
-          std::lock_guard<std::mutex> lock(error_message_mutex_);
-          error_message_ = ("Something went wrong during setting another Windows version.\n" + Glib::ustring(error.what()));
-        }
-        caller->signal_error_message_during_update();
-        return; // Stop thread prematurely
-      }
-    }
-
-    if (active_bottle_->virtual_desktop() != virtual_desktop_resolution)
-    {
-      if (!virtual_desktop_resolution.empty())
-      {
-        try
-        {
-          Helper::set_virtual_desktop(prefix_path, virtual_desktop_resolution);
-        }
-        catch (const std::runtime_error& error)
-        {
-          {
-            std::lock_guard<std::mutex> lock(error_message_mutex_);
-            error_message_ = ("Something went wrong during enabling virtual desktop mode.\n" + Glib::ustring(error.what()));
-          }
-          caller->signal_error_message_during_update();
-          return; // Stop thread prematurely
-        }
-      }
-      else
-      {
-        try
-        {
-          Helper::disable_virtual_desktop(prefix_path);
-        }
-        catch (const std::runtime_error& error)
-        {
-          {
-            std::lock_guard<std::mutex> lock(error_message_mutex_);
-            error_message_ = ("Something went wrong during disabling virtual desktop mode.\n" + Glib::ustring(error.what()));
-          }
-          caller->signal_error_message_during_update();
-          return; // Stop thread prematurely
-        }
-      }
-    }
-    if (active_bottle_->audio_driver() != audio)
-    {
-      try
-      {
-        Helper::set_audio_driver(prefix_path, audio);
-      }
-      catch (const std::runtime_error& error)
-      {
-        {
-          std::lock_guard<std::mutex> lock(error_message_mutex_);
-          error_message_ = ("Something went wrong during setting another audio driver.\n" + Glib::ustring(error.what()));
-        }
-        caller->signal_error_message_during_update();
-        return; // Stop thread prematurely
-      }
+      caller->signal_error_message_during_update(operation_id, error.what());
     }
-
-    // Wait until wineserver terminates
-    Helper::wait_until_wineserver_is_terminated(prefix_path);
-
-    // LAST but not least, rename Wine bottle folder
-    // Do this after the wait on wineserver, since otherwise renaming may break the Wine installation during update
-    if (active_bottle_->folder_name() != folder_name)
+    catch (...)
     {
-      // Build new prefix
-      std::vector<string> dirs{bottle_location_, folder_name};
-      string new_prefix_path = Glib::build_path(G_DIR_SEPARATOR_S, dirs);
-      try
-      {
-        Helper::rename_wine_bottle_folder(prefix_path, new_prefix_path);
-      }
-      catch (const std::runtime_error& error)
-      {
-        {
-          std::lock_guard<std::mutex> lock(error_message_mutex_);
-          error_message_ = ("Something went wrong during during changing the folder name.\n" + Glib::ustring(error.what()));
-        }
-        caller->signal_error_message_during_update();
-        return; // Stop thread prematurely
-      }
+      // Always signal the result, the dialog is busy until then
+      caller->signal_error_message_during_update(operation_id, "Unknown error");
     }
-  }
-  else
-  {
+    if (!new_prefix_path.empty())
     {
-      std::lock_guard<std::mutex> lock(error_message_mutex_);
-      error_message_ = "No current Windows Machine was set?";
+      std::lock_guard<std::mutex> lock(rename_destinations_mutex_);
+      rename_destinations_.erase(new_prefix_path);
     }
-    caller->signal_error_message_during_update();
-    return; // Stop thread prematurely
-  }
-
-  // Trigger done signal
-  caller->signal_bottle_updated();
+  });
 }
 
 /**
@@ -530,7 +667,7 @@ void BottleManager::delete_bottle()
         // Signal that bottle is removed
         bottle_removed.emit();
         Helper::remove_wine_bottle(prefix_path);
-        this->update_config_and_bottles(false);
+        this->update_config_and_bottles();
       }
       else
       {
@@ -561,13 +698,12 @@ void BottleManager::set_active_bottle(BottleItem* bottle)
 }
 
 /**
- * \brief Get error message (stored from manager thread)
- * \return Return the error message
+ * \brief Get the job list, the running and the last finished bottle actions (see jobs_changed signal)
+ * \return Jobs by job number
  */
-const Glib::ustring& BottleManager::get_error_message() const
+std::vector<JobInfo> BottleManager::get_jobs() const
 {
-  std::lock_guard<std::mutex> lock(error_message_mutex_);
-  return error_message_;
+  return job_scheduler_.get_jobs();
 }
 
 /**
@@ -585,22 +721,12 @@ void BottleManager::run_executable(string filename, bool is_msi_file = false)
     string program_prefix = is_msi_file ? "msiexec /i" : "start /unix";
     // Be-sure to execute the filename also between quotes (due to spaces)
     string program = program_prefix + " \"" + filename + "\"";
-    std::thread t([wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
-                   debug_logging = std::move(is_debug_logging), output_logging_mutex = std::ref(output_loging_mutex_),
-                   logging_bottle_prefix = std::ref(logging_bottle_prefix_), output_logging = std::ref(output_logging_),
-                   write_log_dispatcher = &write_log_dispatcher_] {
-      string output = Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, program, true, logging_stderr);
-      if (debug_logging && !output.empty())
-      {
-        {
-          std::lock_guard<std::mutex> lock(output_logging_mutex);
-          logging_bottle_prefix.get() = wine_prefix;
-          output_logging.get() = output;
-        }
-        write_log_dispatcher->emit();
-      }
+    string description = "Run " + Glib::path_get_basename(filename);
+    job_scheduler_.launch(wine_prefix, description, [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, program,
+                                                     logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging)] {
+      LogSink log_sink(Helper::get_log_file_path(wine_prefix), debug_logging);
+      Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, program, log_sink, true, logging_stderr);
     });
-    t.detach();
   }
 }
 
@@ -615,47 +741,26 @@ void BottleManager::run_program(string program)
     string wine_prefix = active_bottle_->wine_location();
     bool is_debug_logging = active_bottle_->is_debug_logging();
     int debug_log_level = active_bottle_->debug_log_level();
+    string description = "Run " + Glib::path_get_basename(program);
     // For all programs (except winetricks)
     if (!program.ends_with("winetricks --gui"))
     {
       // Between quotes (due to spaces)
       program = "\"" + program + "\"";
-      std::thread t([wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
-                     debug_logging = std::move(is_debug_logging), output_logging_mutex = std::ref(output_loging_mutex_),
-                     logging_bottle_prefix = std::ref(logging_bottle_prefix_), output_logging = std::ref(output_logging_),
-                     write_log_dispatcher = &write_log_dispatcher_] {
-        string output = Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, program, true, logging_stderr);
-        if (debug_logging && !output.empty())
-        {
-          {
-            std::lock_guard<std::mutex> lock(output_logging_mutex);
-            logging_bottle_prefix.get() = wine_prefix;
-            output_logging.get() = output;
-          }
-          write_log_dispatcher->emit();
-        }
+      job_scheduler_.launch(wine_prefix, description, [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, program,
+                                                       logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging)] {
+        LogSink log_sink(Helper::get_log_file_path(wine_prefix), debug_logging);
+        Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, program, log_sink, true, logging_stderr);
       });
-      t.detach();
     }
     else
     {
       // We have an exception for winetricks, since that doesn't need the wine command
-      std::thread t([wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
-                     debug_logging = std::move(is_debug_logging), output_logging_mutex = std::ref(output_loging_mutex_),
-                     logging_bottle_prefix = std::ref(logging_bottle_prefix_), output_logging = std::ref(output_logging_),
-                     write_log_dispatcher = &write_log_dispatcher_] {
-        string output = Helper::run_program(wine_prefix, debug_log_level, program, true, logging_stderr);
-        if (debug_logging && !output.empty())
-        {
-          {
-            std::lock_guard<std::mutex> lock(output_logging_mutex);
-            logging_bottle_prefix.get() = wine_prefix;
-            output_logging.get() = output;
-          }
-          write_log_dispatcher->emit();
-        }
+      job_scheduler_.launch(wine_prefix, description, [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
+                                                       debug_logging = std::move(is_debug_logging)] {
+        LogSink log_sink(Helper::get_log_file_path(wine_prefix), debug_logging);
+        Helper::run_program(wine_prefix, debug_log_level, program, log_sink, true, logging_stderr);
       });
-      t.detach();
     }
   }
 }
@@ -684,22 +789,11 @@ void BottleManager::reboot()
     string wine_prefix = active_bottle_->wine_location();
     bool is_debug_logging = active_bottle_->is_debug_logging();
     int debug_log_level = active_bottle_->debug_log_level();
-    std::thread t([wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, logging_stderr = std::move(is_logging_stderr_),
-                   debug_logging = std::move(is_debug_logging), output_logging_mutex = std::ref(output_loging_mutex_),
-                   logging_bottle_prefix = std::ref(logging_bottle_prefix_), output_logging = std::ref(output_logging_),
-                   write_log_dispatcher = &write_log_dispatcher_] {
-      string output = Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, "wineboot -r", true, logging_stderr);
-      if (debug_logging && !output.empty())
-      {
-        {
-          std::lock_guard<std::mutex> lock(output_logging_mutex);
-          logging_bottle_prefix.get() = wine_prefix;
-          output_logging.get() = output;
-        }
-        write_log_dispatcher->emit();
-      }
+    job_scheduler_.post(wine_prefix, "Reboot", [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level,
+                                                logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging)] {
+      LogSink log_sink(Helper::get_log_file_path(wine_prefix), debug_logging);
+      Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, "wineboot -r", log_sink, true, logging_stderr);
     });
-    t.detach();
     main_window_.show_info_message("Machine emulate reboot requested.");
   }
 }
@@ -714,25 +808,15 @@ void BottleManager::update()
     string wine_prefix = active_bottle_->wine_location();
     bool is_debug_logging = active_bottle_->is_debug_logging();
     int debug_log_level = active_bottle_->debug_log_level();
-    std::thread t([wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, update_bottles_dispatcher = &update_bottles_dispatcher_,
-                   logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-                   output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-                   output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_] {
-      string output = Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, "wineboot -u", true, logging_stderr);
-      if (debug_logging && !output.empty())
-      {
-        {
-          std::lock_guard<std::mutex> lock(output_logging_mutex);
-          logging_bottle_prefix.get() = wine_prefix;
-          output_logging.get() = output;
-        }
-        write_log_dispatcher->emit();
-      }
+    job_scheduler_.post(wine_prefix, "Update", [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level,
+                                                update_bottles_dispatcher = &update_bottles_dispatcher_,
+                                                logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging)] {
+      LogSink log_sink(Helper::get_log_file_path(wine_prefix), debug_logging);
+      Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, "wineboot -u", log_sink, true, logging_stderr);
       Helper::wait_until_wineserver_is_terminated(wine_prefix);
       // Emit update bottles (via dispatcher, so the GUI update can take place in the GUI thread)
       update_bottles_dispatcher->emit();
     });
-    t.detach();
   }
 }
 
@@ -770,22 +854,12 @@ void BottleManager::kill_processes()
     string wine_prefix = active_bottle_->wine_location();
     bool is_debug_logging = active_bottle_->is_debug_logging();
     int debug_log_level = active_bottle_->debug_log_level();
-    std::thread t([wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level, logging_stderr = std::move(is_logging_stderr_),
-                   debug_logging = std::move(is_debug_logging), output_logging_mutex = std::ref(output_loging_mutex_),
-                   logging_bottle_prefix = std::ref(logging_bottle_prefix_), output_logging = std::ref(output_logging_),
-                   write_log_dispatcher = &write_log_dispatcher_] {
-      string output = Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, "wineboot -k", true, logging_stderr);
-      if (debug_logging && !output.empty())
-      {
-        {
-          std::lock_guard<std::mutex> lock(output_logging_mutex);
-          logging_bottle_prefix.get() = wine_prefix;
-          output_logging.get() = output;
-        }
-        write_log_dispatcher->emit();
-      }
+    job_scheduler_.launch(wine_prefix, "Kill processes", [wine64 = std::move(is_wine64_bit_), wine_prefix, debug_log_level,
+                                                          logging_stderr = std::move(is_logging_stderr_),
+                                                          debug_logging = std::move(is_debug_logging)] {
+      LogSink log_sink(Helper::get_log_file_path(wine_prefix), debug_logging);
+      Helper::run_program_under_wine(wine64, wine_prefix, debug_log_level, "wineboot -k", log_sink, true, logging_stderr);
     });
-    t.detach();
     main_window_.show_info_message("Kill processes requested.");
   }
 }
@@ -812,24 +886,11 @@ void BottleManager::install_d3dx9(Gtk::Window& parent, const string& version)
     int debug_log_level = active_bottle_->debug_log_level();
     string program = Helper::get_winetricks_location() + " -q " + package;
     // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t([wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-                   output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-                   output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-                   finish_dispatcher = &finished_package_install_dispatcher] {
-      string output = Helper::run_program(wine_prefix, debug_log_level, program, true, logging_stderr);
-      if (debug_logging && !output.empty())
-      {
-        {
-          std::lock_guard<std::mutex> lock(output_logging_mutex);
-          logging_bottle_prefix.get() = wine_prefix;
-          output_logging.get() = output;
-        }
-        write_log_dispatcher->emit();
-      }
-      Helper::wait_until_wineserver_is_terminated(wine_prefix);
-      finish_dispatcher->emit();
+    job_scheduler_.post(wine_prefix, "Install " + package, [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
+                                                            debug_logging = std::move(is_debug_logging),
+                                                            finish_dispatcher = &finished_package_install_dispatcher] {
+      run_install_program(wine_prefix, debug_log_level, program, debug_logging, logging_stderr, *finish_dispatcher);
     });
-    t.detach();
   }
 }
 
@@ -856,24 +917,11 @@ void BottleManager::install_dxvk(Gtk::Window& parent, const string& version)
     int debug_log_level = active_bottle_->debug_log_level();
     string program = Helper::get_winetricks_location() + " -q " + package;
     // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t([wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-                   output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-                   output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-                   finish_dispatcher = &finished_package_install_dispatcher] {
-      string output = Helper::run_program(wine_prefix, debug_log_level, program, true, logging_stderr);
-      if (debug_logging && !output.empty())
-      {
-        {
-          std::lock_guard<std::mutex> lock(output_logging_mutex);
-          logging_bottle_prefix.get() = wine_prefix;
-          output_logging.get() = output;
-        }
-        write_log_dispatcher->emit();
-      }
-      Helper::wait_until_wineserver_is_terminated(wine_prefix);
-      finish_dispatcher->emit();
+    job_scheduler_.post(wine_prefix, "Install " + package, [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
+                                                            debug_logging = std::move(is_debug_logging),
+                                                            finish_dispatcher = &finished_package_install_dispatcher] {
+      run_install_program(wine_prefix, debug_log_level, program, debug_logging, logging_stderr, *finish_dispatcher);
     });
-    t.detach();
   }
 }
 
@@ -895,24 +943,11 @@ void BottleManager::install_visual_cpp_package(Gtk::Window& parent, const string
     int debug_log_level = active_bottle_->debug_log_level();
     string program = Helper::get_winetricks_location() + " -q " + package;
     // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t([wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-                   output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-                   output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-                   finish_dispatcher = &finished_package_install_dispatcher] {
-      string output = Helper::run_program(wine_prefix, debug_log_level, program, true, logging_stderr);
-      if (debug_logging && !output.empty())
-      {
-        {
-          std::lock_guard<std::mutex> lock(output_logging_mutex);
-          logging_bottle_prefix.get() = wine_prefix;
-          output_logging.get() = output;
-        }
-        write_log_dispatcher->emit();
-      }
-      Helper::wait_until_wineserver_is_terminated(wine_prefix);
-      finish_dispatcher->emit();
+    job_scheduler_.post(wine_prefix, "Install " + package, [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
+                                                            debug_logging = std::move(is_debug_logging),
+                                                            finish_dispatcher = &finished_package_install_dispatcher] {
+      run_install_program(wine_prefix, debug_log_level, program, debug_logging, logging_stderr, *finish_dispatcher);
     });
-    t.detach();
   }
 }
 
@@ -953,24 +988,11 @@ void BottleManager::install_dot_net(Gtk::Window& parent, const string& version)
         program = install_command;
       }
       // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-      std::thread t([wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
-                     debug_logging = std::move(is_debug_logging), output_logging_mutex = std::ref(output_loging_mutex_),
-                     logging_bottle_prefix = std::ref(logging_bottle_prefix_), output_logging = std::ref(output_logging_),
-                     write_log_dispatcher = &write_log_dispatcher_, finish_dispatcher = &finished_package_install_dispatcher] {
-        string output = Helper::run_program(wine_prefix, debug_log_level, program, true, logging_stderr);
-        if (debug_logging && !output.empty())
-        {
-          {
-            std::lock_guard<std::mutex> lock(output_logging_mutex);
-            logging_bottle_prefix.get() = wine_prefix;
-            output_logging.get() = output;
-          }
-          write_log_dispatcher->emit();
-        }
-        Helper::wait_until_wineserver_is_terminated(wine_prefix);
-        finish_dispatcher->emit();
+      job_scheduler_.post(wine_prefix, "Install " + package, [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
+                                                              debug_logging = std::move(is_debug_logging),
+                                                              finish_dispatcher = &finished_package_install_dispatcher] {
+        run_install_program(wine_prefix, debug_log_level, program, debug_logging, logging_stderr, *finish_dispatcher);
       });
-      t.detach();
     }
     else
     {
@@ -995,24 +1017,11 @@ void BottleManager::install_core_fonts(Gtk::Window& parent)
     int debug_log_level = active_bottle_->debug_log_level();
     string program = Helper::get_winetricks_location() + " -q corefonts";
     // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t([wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-                   output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-                   output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-                   finish_dispatcher = &finished_package_install_dispatcher] {
-      string output = Helper::run_program(wine_prefix, debug_log_level, program, true, logging_stderr);
-      if (debug_logging && !output.empty())
-      {
-        {
-          std::lock_guard<std::mutex> lock(output_logging_mutex);
-          logging_bottle_prefix.get() = wine_prefix;
-          output_logging.get() = output;
-        }
-        write_log_dispatcher->emit();
-      }
-      Helper::wait_until_wineserver_is_terminated(wine_prefix);
-      finish_dispatcher->emit();
+    job_scheduler_.post(wine_prefix, "Install core fonts", [wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_),
+                                                            debug_logging = std::move(is_debug_logging),
+                                                            finish_dispatcher = &finished_package_install_dispatcher] {
+      run_install_program(wine_prefix, debug_log_level, program, debug_logging, logging_stderr, *finish_dispatcher);
     });
-    t.detach();
   }
 }
 
@@ -1032,24 +1041,12 @@ void BottleManager::install_liberation(Gtk::Window& parent)
     int debug_log_level = active_bottle_->debug_log_level();
     string program = Helper::get_winetricks_location() + " -q liberation";
     // finished_package_install_dispatcher signal is needed in order to close the busy dialog again
-    std::thread t([wine_prefix, debug_log_level, program, logging_stderr = std::move(is_logging_stderr_), debug_logging = std::move(is_debug_logging),
-                   output_logging_mutex = std::ref(output_loging_mutex_), logging_bottle_prefix = std::ref(logging_bottle_prefix_),
-                   output_logging = std::ref(output_logging_), write_log_dispatcher = &write_log_dispatcher_,
-                   finish_dispatcher = &finished_package_install_dispatcher] {
-      string output = Helper::run_program(wine_prefix, debug_log_level, program, true, logging_stderr);
-      if (debug_logging && !output.empty())
-      {
-        {
-          std::lock_guard<std::mutex> lock(output_logging_mutex);
-          logging_bottle_prefix.get() = wine_prefix;
-          output_logging.get() = output;
-        }
-        write_log_dispatcher->emit();
-      }
-      Helper::wait_until_wineserver_is_terminated(wine_prefix);
-      finish_dispatcher->emit();
+    job_scheduler_.post(wine_prefix, "Install liberation fonts", [wine_prefix, debug_log_level, program,
+                                                                  logging_stderr = std::move(is_logging_stderr_),
+                                                                  debug_logging = std::move(is_debug_logging),
+                                                                  finish_dispatcher = &finished_package_install_dispatcher] {
+      run_install_program(wine_prefix, debug_log_level, program, debug_logging, logging_stderr, *finish_dispatcher);
     });
-    t.detach();
   }
 }
 
@@ -1057,6 +1054,248 @@ void BottleManager::install_liberation(Gtk::Window& parent)
  * Private member functions                                  *
  *************************************************************/
 
+/**
+ * \brief Create a new Wine Bottle (runs in thread)
+ * \param[in] is_wine64_bit               Use Wine 64-bit binary
+ * \param[in] prefix_path                 Bottle prefix
+ * \param[in] name                        Bottle Name
+ * \param[in] windows_version             Windows OS version
+ * \param[in] bit                         Windows Bit (32/64-bit)
+ * \param[in] virtual_desktop_resolution  Virtual desktop resolution (empty if disabled)
+ * \param[in] disable_gecko_mono          Disable Gecko/Mono install
+ * \param[in] audio                       Audio Driver type
+ * \throws runtime_error with the error message for the user
+ */
+void BottleManager::create_bottle(bool is_wine64_bit,
+                                  const string& prefix_path,
+                                  const Glib::ustring& name,
+                                  BottleTypes::Windows windows_version,
+                                  BottleTypes::Bit bit,
+                                  const Glib::ustring& virtual_desktop_resolution,
+                                  bool disable_gecko_mono,
+                                  BottleTypes::AudioDriver audio)
+{
+  // First check if wine is installed
+  int wineStatus = Helper::determine_wine_executable();
+  if (wineStatus == -1)
+  {
+    throw std::runtime_error("Could not find wine binary. Please first install wine on your machine.");
+  }
+
+  try
+  {
+    // Now create a new Wine Bottle
+    Helper::create_wine_bottle(is_wine64_bit, prefix_path, bit, disable_gecko_mono);
+    // Create default Bottle config data struct
+    BottleConfigData bottle_config;
+    bottle_config.name = name;
+    bottle_config.description = "";        // By default empty description
+    bottle_config.logging_enabled = false; // By default disable logging
+    bottle_config.debug_log_level = 1;     // 1 (default) = Normal debug log level
+    // Create empty custom app list
+    std::map<int, ApplicationData> app_list;
+    // Next, write the WineGUI bottle config file
+    if (!BottleConfigFile::write_config_file(prefix_path, bottle_config, app_list))
+    {
+      // TODO: Maybe a warning message to the user?
+      // No critical failure, only log an error to console.
+      std::cout << "Error: Could not write bottle config file." << std::endl;
+    }
+  }
+  catch (const std::runtime_error& error)
+  {
+    throw std::runtime_error("Something went wrong during creation of a new Windows machine!\n" + string(error.what()));
+  }
+
+  // Continue with additional settings
+  // Wait until wineserver terminates, so the registry can be changed directly on disk
+  Helper::wait_until_wineserver_is_terminated(prefix_path);
+
+  // Only change Windows OS when NOT default
+  if (windows_version != WineDefaults::WindowsOs)
+  {
+    try
+    {
+      Helper::set_windows_version(is_wine64_bit, prefix_path, windows_version);
+    }
+    catch (const std::runtime_error& error)
+    {
+      throw std::runtime_error("Something went wrong during setting another Windows version.\n" + string(error.what()));
+    }
+  }
+
+  // Only if virtual desktop is not empty, enable it
+  if (!virtual_desktop_resolution.empty())
+  {
+    try
+    {
+      Helper::set_virtual_desktop(is_wine64_bit, prefix_path, virtual_desktop_resolution);
+    }
+    catch (const std::runtime_error& error)
+    {
+      throw std::runtime_error("Something went wrong during enabling virtual desktop mode.\n" + string(error.what()));
+    }
+  }
+
+  // Only if Audio driver is not default, change it
+  if (audio != WineDefaults::AudioDriver)
+  {
+    try
+    {
+      Helper::set_audio_driver(is_wine64_bit, prefix_path, audio);
+    }
+    catch (const std::runtime_error& error)
+    {
+      throw std::runtime_error("Something went wrong during setting another audio driver.\n" + string(error.what()));
+    }
+  }
+
+  // Wait until wineserver terminates
+  Helper::wait_until_wineserver_is_terminated(prefix_path);
+}
+
+/**
+ * \brief Update existing Wine bottle, only the changed settings are applied (runs in thread)
+ * The settings are compared with the bottle itself when the job runs, since earlier jobs of the same bottle can have changed it.
+ * \param[in] is_wine64_bit               Use Wine 64-bit binary
+ * \param[in] prefix_path                 Bottle prefix
+ * \param[in] name                        Bottle Name
+ * \param[in] folder_name                 Bottle Folder Name
+ * \param[in] description                 Description text
+ * \param[in] windows_version             Windows OS version
+ * \param[in] virtual_desktop_resolution  Virtual desktop resolution (empty if disabled)
+ * \param[in] audio                       Audio Driver type
+ * \param[in] is_debug_logging            Enable/disable debug logging to disk
+ * \param[in] debug_log_level             Bottle Debug Log Level
+ * \throws runtime_error with the error message for the user
+ */
+void BottleManager::change_bottle(bool is_wine64_bit,
+                                  const string& prefix_path,
+                                  const Glib::ustring& name,
+                                  const Glib::ustring& folder_name,
+                                  const Glib::ustring& description,
+                                  BottleTypes::Windows windows_version,
+                                  const Glib::ustring& virtual_desktop_resolution,
+                                  BottleTypes::AudioDriver audio,
+                                  bool is_debug_logging,
+                                  int debug_log_level)
+{
+  // An earlier job could have renamed or removed the bottle
+  if (!Helper::dir_exists(prefix_path))
+  {
+    throw std::runtime_error("The machine folder doesn't exist anymore (renamed or removed in the meantime):\n" + prefix_path);
+  }
+  BottleProbeData current = BottleProbe::probe(prefix_path);
+
+  bool need_update_bottle_config_file = false;
+  BottleConfigData bottle_config;
+  std::map<int, ApplicationData> app_list; // App list is never dirty, so no need to check
+  std::tie(bottle_config, app_list) = BottleConfigFile::read_config_file(prefix_path);
+  if (current.name != name)
+  {
+    bottle_config.name = name;
+    need_update_bottle_config_file = true;
+  }
+  if (current.description != description)
+  {
+    bottle_config.description = description;
+    need_update_bottle_config_file = true;
+  }
+  if (current.debug_logging_enabled != is_debug_logging)
+  {
+    bottle_config.logging_enabled = is_debug_logging;
+    need_update_bottle_config_file = true;
+  }
+  if (current.debug_log_level != debug_log_level)
+  {
+    bottle_config.debug_log_level = debug_log_level;
+    need_update_bottle_config_file = true;
+  }
+
+  if (need_update_bottle_config_file)
+  {
+    if (!BottleConfigFile::write_config_file(prefix_path, bottle_config, app_list))
+    {
+      // Silent error
+      std::cout << "Error: Could not update bottle config file." << std::endl;
+    }
+  }
+
+  if (current.windows != windows_version)
+  {
+    try
+    {
+      Helper::set_windows_version(is_wine64_bit, prefix_path, windows_version);
+    }
+    catch (const std::runtime_error& error)
+    {
+      throw std::runtime_error("Something went wrong during setting another Windows version.\n" + string(error.what()));
+    }
+  }
+
+  if (current.virtual_desktop != virtual_desktop_resolution)
+  {
+    if (!virtual_desktop_resolution.empty())
+    {
+      try
+      {
+        Helper::set_virtual_desktop(is_wine64_bit, prefix_path, virtual_desktop_resolution);
+      }
+      catch (const std::runtime_error& error)
+      {
+        throw std::runtime_error("Something went wrong during enabling virtual desktop mode.\n" + string(error.what()));
+      }
+    }
+    else
+    {
+      try
+      {
+        Helper::disable_virtual_desktop(is_wine64_bit, prefix_path);
+      }
+      catch (const std::runtime_error& error)
+      {
+        throw std::runtime_error("Something went wrong during disabling virtual desktop mode.\n" + string(error.what()));
+      }
+    }
+  }
+  if (current.audio_driver != audio)
+  {
+    try
+    {
+      Helper::set_audio_driver(is_wine64_bit, prefix_path, audio);
+    }
+    catch (const std::runtime_error& error)
+    {
+      throw std::runtime_error("Something went wrong during setting another audio driver.\n" + string(error.what()));
+    }
+  }
+
+  // Wait until wineserver terminates
+  Helper::wait_until_wineserver_is_terminated(prefix_path);
+
+  // LAST but not least, rename Wine bottle folder
+  // Do this after the wait on wineserver, since otherwise renaming may break the Wine installation during update
+  if (current.folder_name != folder_name)
+  {
+    // Build new prefix, in the same bottle location
+    std::vector<string> dirs{Glib::path_get_dirname(prefix_path), folder_name};
+    string new_prefix_path = Glib::build_path(G_DIR_SEPARATOR_S, dirs);
+    // The folder could be created outside of WineGUI in the meantime
+    if (Helper::dir_exists(new_prefix_path))
+    {
+      throw std::runtime_error("Could not change the folder name, the folder already exists:\n" + new_prefix_path);
+    }
+    try
+    {
+      Helper::rename_wine_bottle_folder(prefix_path, new_prefix_path);
+    }
+    catch (const std::runtime_error& error)
+    {
+      throw std::runtime_error("Something went wrong during during changing the folder name.\n" + string(error.what()));
+    }
+  }
+}
+
 /**
  * \brief Load general configuration values from file and save them
  * \return GeneralConfigData
@@ -1065,6 +1304,14 @@ GeneralConfigData BottleManager::load_and_save_general_config()
 {
   GeneralConfigData general_config = GeneralConfigFile::read_config_file();
   bottle_location_ = general_config.default_folder;
+  // New bottles are only created in the default folder, the bottles of the additional folders are listed as well
+  bottle_locations_ = {bottle_location_};
+  for (const string& folder : general_config.additional_folders)
+  {
+    if (std::find(bottle_locations_.begin(), bottle_locations_.end(), folder) == bottle_locations_.end())
+      bottle_locations_.push_back(folder);
+  }
+  bottle_scan_depth_ = general_config.folder_scan_depth;
   is_display_default_wine_machine_ = general_config.display_default_wine_machine;
   is_wine64_bit_ = ((Helper::determine_wine_executable() == 1) || general_config.prefer_wine64);
   is_logging_stderr_ = general_config.enable_logging_stderr;
@@ -1132,11 +1379,10 @@ string BottleManager::get_wine_version()
 }
 
 /**
- * \brief Get Bottle Paths
+ * \brief Create the default bottle location, if it doesn't exist yet
  * \throws runtime_error when we can not created a Wine bottle directory or configuration folder could not be found
- * \return Return a map of bottle paths (string) and modification time (in ms)
  */
-std::vector<string> BottleManager::get_bottle_paths()
+void BottleManager::create_bottle_location()
 {
   if (!Helper::dir_exists(bottle_location_))
   {
@@ -1146,119 +1392,184 @@ std::vector<string> BottleManager::get_bottle_paths()
       throw std::runtime_error("Failed to create the Wine bottle directory: " + bottle_location_);
     }
   }
-  if (Helper::dir_exists(bottle_location_))
-  {
-    // Continue
-    return Helper::get_bottles_paths(bottle_location_, is_display_default_wine_machine_);
-  }
-  else
+  if (!Helper::dir_exists(bottle_location_))
   {
     throw std::runtime_error("Configuration directory still not found (probably no permissions):\n" + bottle_location_);
   }
-  // Otherwise empty
-  return std::vector<string>();
 }
 
 /**
- * \brief Create wine BottleItem objects and add them to a list.
- * \param[in] bottle_dirs  The list of bottle directories
- * \returns Array of Bottle Items
+ * \brief Scan all the bottle locations for bottles, each location in one of the worker threads.
+ * The bottle list is updated as soon as a location is scanned (see on_bottle_paths_found()), so a slow disk only delays its own bottles.
  */
-std::list<BottleItem> BottleManager::create_wine_bottles(std::vector<string> bottle_dirs)
+void BottleManager::scan_bottle_locations()
 {
-  std::list<BottleItem> bottles;
-  Glib::ustring wine_version = get_wine_version();
+  ++scan_generation_;
+  is_scan_applied_ = false;
+  scan_pool_.cancel_pending();
 
-  // Retrieve detailed info for each wine bottle prefix
-  for (const string& prefix : bottle_dirs)
+  // The bottles of a location are kept until the location is scanned again, so they don't disappear in the meantime
+  std::vector<std::vector<BottlePath>> found_paths(bottle_locations_.size());
+  for (std::size_t index = 0; index < bottle_locations_.size(); ++index)
   {
-    // Reset variables
-    Glib::ustring name = "";
-    Glib::ustring folder_name = "";
-    Glib::ustring description = "";
-    Glib::ustring virtual_desktop = "";
-    BottleTypes::Bit bit = BottleTypes::Bit::win32;
-    Glib::ustring c_drive_location = "- Unknown -";
-    Glib::ustring last_time_wine_updated = "- Unknown -";
-    BottleTypes::AudioDriver audio_driver = BottleTypes::AudioDriver::pulseaudio;
-    BottleTypes::Windows windows = WineDefaults::WindowsOs;
-    bool debug_logging_enabled = false;
-    int debug_log_level = 1;
-    bool status = false;
-
-    // Retrieve bottle config data & custom app list
-    BottleConfigData bottle_config;
-    std::map<int, ApplicationData> bottle_app_list;
-    std::tie(bottle_config, bottle_app_list) = BottleConfigFile::read_config_file(prefix);
-    name = bottle_config.name;
-    description = bottle_config.description;
-    debug_logging_enabled = bottle_config.logging_enabled;
-    debug_log_level = bottle_config.debug_log_level;
+    auto previous = std::find(scanned_locations_.begin(), scanned_locations_.end(), bottle_locations_.at(index));
+    if (previous != scanned_locations_.end())
+      found_paths.at(index) = std::move(scanned_paths_.at(previous - scanned_locations_.begin()));
+  }
+  scanned_locations_ = bottle_locations_;
+  scanned_paths_.swap(found_paths);
 
-    try
-    {
-      folder_name = Helper::get_folder_name(prefix);
-    }
-    catch (const std::runtime_error& error)
-    {
-      main_window_.show_error_message(error.what());
-    }
+  for (std::size_t index = 0; index < scanned_locations_.size(); ++index)
+  {
+    scan_pool_.post([this, generation = scan_generation_, index, location = scanned_locations_.at(index), depth = bottle_scan_depth_] {
+      ScanResult result{generation, index, Helper::find_bottles_paths(location, depth)};
+      {
+        std::lock_guard<std::mutex> lock(scan_results_mutex_);
+        scan_results_.push_back(std::move(result));
+      }
+      scan_finished_dispatcher_.emit();
+    });
+  }
+}
 
-    try
-    {
-      bit = Helper::get_windows_bitness(prefix);
-    }
-    catch (const std::runtime_error& error)
+/**
+ * \brief Retrieve the details of all bottles in parallel (in the worker threads).
+ * Every finished bottle is signaled to the GUI thread, see on_bottle_details_retrieved().
+ */
+void BottleManager::retrieve_bottle_details()
+{
+  pending_probes_ = 0;
+  latest_probes_.clear();
+  for (std::size_t index = 0; index < records_.size(); ++index)
+  {
+    retrieve_bottle_details(index);
+  }
+}
+
+/**
+ * \brief Retrieve the details of a single bottle (in one of the worker threads)
+ * \param[in] index Index of the bottle in the current bottle list
+ */
+void BottleManager::retrieve_bottle_details(std::size_t index)
+{
+  string prefix_path = records_.at(index).prefix_path;
+  BottleCacheEntry cached;
+  auto cache_it = bottle_cache_.find(prefix_path);
+  if (cache_it != bottle_cache_.end())
+    cached = cache_it->second;
+
+  ++pending_probes_;
+  latest_probes_.insert_or_assign(prefix_path, ++probe_sequence_);
+  probe_pool_.post([this, generation = probe_generation_, sequence = probe_sequence_, prefix_path, cached] {
+    ProbeResult result{generation, sequence, prefix_path, BottleCacheFile::get_file_stamp(prefix_path), false, {}};
+    // Cached details are only used when none of the bottle files are changed since
+    result.is_from_cache = (!cached.file_stamp.empty() && cached.file_stamp == result.file_stamp);
+    result.data = (result.is_from_cache) ? cached.data : BottleProbe::probe(prefix_path);
     {
-      main_window_.show_error_message(error.what());
+      std::lock_guard<std::mutex> lock(probe_results_mutex_);
+      probe_results_.push_back(std::move(result));
     }
+    probe_finished_dispatcher_.emit();
+  });
+}
+
+/**
+ * \brief Calculate the disk usage of all bottles in the background (in the worker threads).
+ * Unchanged directories are not read again, see DiskUsage.
+ */
+void BottleManager::retrieve_disk_usage()
+{
+  for (std::size_t index = 0; index < records_.size(); ++index)
+  {
+    retrieve_disk_usage(index);
+  }
+}
+
+/**
+ * \brief Calculate the disk usage of a single bottle (in one of the worker threads)
+ * \param[in] index Index of the bottle in the current bottle list
+ */
+void BottleManager::retrieve_disk_usage(std::size_t index)
+{
+  string prefix_path = records_.at(index).prefix_path;
+  disk_usage_pool_.post([this, generation = probe_generation_, prefix_path] {
+    DiskUsageResult result{generation, prefix_path, -1};
     try
     {
-      c_drive_location = Helper::get_c_letter_drive(prefix);
+      result.disk_usage = DiskUsage::get_disk_usage(prefix_path);
     }
     catch (const std::runtime_error& error)
     {
-      main_window_.show_error_message(error.what());
+      std::cerr << "WARN: " << error.what() << std::endl;
     }
-    try
     {
-      last_time_wine_updated = Helper::get_last_wine_updated(prefix);
+      std::lock_guard<std::mutex> lock(disk_usage_results_mutex_);
+      disk_usage_results_.push_back(std::move(result));
     }
-    catch (const std::runtime_error& error)
+    disk_usage_dispatcher_.emit();
+  });
+}
+
+/**
+ * \brief Watch the bottle locations for added/removed bottles, and each bottle prefix for changed bottle files.
+ * Watches of removed bottle locations and bottles are stopped.
+ */
+void BottleManager::update_file_monitors()
+{
+  std::map<string, Glib::RefPtr<Gio::FileMonitor>> bottle_location_monitors;
+  for (const string& bottle_location : bottle_locations_)
+  {
+    auto existing_monitor = bottle_location_monitors_.extract(bottle_location);
+    if (!existing_monitor.empty())
     {
-      main_window_.show_error_message(error.what());
+      bottle_location_monitors.insert(std::move(existing_monitor));
+      continue;
     }
     try
     {
-      audio_driver = Helper::get_audio_driver(prefix);
-    }
-    catch (const std::runtime_error& error)
-    {
-      main_window_.show_error_message(error.what());
+      auto monitor = Gio::File::create_for_path(bottle_location)->monitor_directory();
+      monitor->signal_changed().connect(sigc::mem_fun(this, &BottleManager::on_bottle_location_changed));
+      bottle_location_monitors.emplace(bottle_location, monitor);
     }
-    try
+    catch (const Glib::Error& error)
     {
-      windows = Helper::get_windows_version(prefix);
-      status = Helper::get_bottle_status(prefix);
+      std::cerr << "WARN: Could not watch the bottle location " << bottle_location << " for changes: " << error.what() << std::endl;
     }
-    catch (const std::runtime_error& error)
+  }
+  // Stops watching the bottle locations that are not configured anymore
+  bottle_location_monitors_.swap(bottle_location_monitors);
+
+  std::map<string, Glib::RefPtr<Gio::FileMonitor>> prefix_monitors;
+  for (const BottleRecord& record : records_)
+  {
+    string prefix_path = record.prefix_path;
+    auto existing_monitor = prefix_monitors_.extract(prefix_path);
+    if (!existing_monitor.empty())
     {
-      main_window_.show_error_message(error.what());
+      prefix_monitors.insert(std::move(existing_monitor));
+      continue;
     }
     try
     {
-      virtual_desktop = Helper::get_virtual_desktop(prefix);
+      // A single watch on the prefix directory, since the registry files are replaced (renamed) by Wine
+      Glib::RefPtr<Gio::FileMonitor> monitor = Gio::File::create_for_path(prefix_path)->monitor_directory();
+      monitor->signal_changed().connect(sigc::bind(sigc::mem_fun(this, &BottleManager::on_prefix_changed), prefix_path));
+      prefix_monitors.emplace(prefix_path, monitor);
     }
-    catch (const std::runtime_error& error)
+    catch (const Glib::Error& error)
     {
-      main_window_.show_error_message(error.what());
+      std::cerr << "WARN: Could not watch the Wine machine for changes: " << error.what() << std::endl;
     }
-
-    Glib::ustring prefix_path(prefix); // Convert to Glib ustring
-    BottleItem* bottle =
-        new BottleItem(name, folder_name, description, status, windows, bit, wine_version, is_wine64_bit_, prefix_path, c_drive_location,
-                       last_time_wine_updated, audio_driver, virtual_desktop, debug_logging_enabled, debug_log_level, bottle_app_list);
-    bottles.push_back(*bottle);
   }
-  return bottles;
+  // The remaining monitors (of the removed bottles) are released
+  prefix_monitors_.swap(prefix_monitors);
+}
+
+/**
+ * \brief Start the refresh timeout (if not yet started), all the file changes until the timeout are handled at once
+ */
+void BottleManager::schedule_refresh()
+{
+  if (!refresh_timeout_.connected())
+    refresh_timeout_ = Glib::signal_timeout().connect(sigc::mem_fun(this, &BottleManager::on_refresh_timeout), RefreshTimeout);
 }
@@ -40,7 +40,8 @@ BottleNewAssistant::BottleNewAssistant()
       virtual_desktop_resolution_label("Window Resolution:"),
       confirm_label("Confirmation page"),
       virtual_desktop_check("Enable Virtual Desktop Window"),
-      disable_gecko_mono_check("Disable Gecko & Mono")
+      disable_gecko_mono_check("Disable Gecko & Mono"),
+      operation_id_(0)
 {
   set_border_width(8);
   set_default_size(640, 400);
@@ -259,10 +260,28 @@ void BottleNewAssistant::get_result(Glib::ustring& name,
 }
 
 /**
- * \brief Triggered when the bottle is fully created (signal from the bottle manager thread)
+ * \brief Start the operation of the applied bottle, the wizard is only finished by the result of this operation
+ * (the wizard can be closed and used again while the previous bottle is still created).
+ * \return Operation number, passed back to bottle_created()
  */
-void BottleNewAssistant::bottle_created()
+std::size_t BottleNewAssistant::start_operation()
 {
+  return ++operation_id_;
+}
+
+/**
+ * \brief Triggered when a bottle is fully created or failed (signal from the bottle manager thread)
+ * \param[in] operation_id Operation number of the created bottle
+ */
+void BottleNewAssistant::bottle_created(std::size_t operation_id)
+{
+  // Another (earlier) bottle is created, only refresh the GUI
+  if (operation_id != operation_id_)
+  {
+    new_bottle_finished.emit();
+    return;
+  }
+
   // Reset defaults (including timer_.disconnect())
   set_default_values();
 
@@ -0,0 +1,111 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    bottle_probe.cc
+ * \brief   Retrieve all the details of a Wine bottle at once
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "bottle_probe.h"
+#include "batch_stat.h"
+#include "bottle_config_file.h"
+#include "helper.h"
+#include "registry_index.h"
+#include <glibmm/miscutils.h>
+#include <stdexcept>
+#include <tuple>
+
+/**
+ * \brief Retrieve all the details of a Wine bottle.
+ * Every directory is checked only once, and both registry files are loaded at most once.
+ * \param[in] prefix_path Bottle prefix
+ * \return Bottle details, including the warnings of the details that could not be retrieved
+ */
+BottleProbeData BottleProbe::probe(const std::string& prefix_path)
+{
+  BottleProbeData data;
+  data.folder_name = Helper::get_folder_name(prefix_path);
+  std::string machine_location = "Wine machine: " + data.folder_name + "\n\nFull location: " + prefix_path;
+
+  // Retrieve bottle config data & custom app list
+  BottleConfigData bottle_config;
+  std::tie(bottle_config, data.app_list) = BottleConfigFile::read_config_file(prefix_path);
+  data.name = bottle_config.name;
+  data.description = bottle_config.description;
+  data.debug_logging_enabled = bottle_config.logging_enabled;
+  data.debug_log_level = bottle_config.debug_log_level;
+
+  // All the directories and the system registry file are looked up at once
+  std::string c_drive_location = Glib::build_filename(prefix_path, "dosdevices", "c:");
+  std::vector<FileStatus> statuses = BatchStat::stat_files(
+      {prefix_path, Glib::build_filename(prefix_path, "dosdevices"), c_drive_location, Glib::build_filename(prefix_path, "system.reg")});
+  bool is_prefix_dir = statuses[0].is_directory();
+  bool is_dosdevices_dir = is_prefix_dir && statuses[1].is_directory();
+  bool is_c_drive_dir = is_dosdevices_dir && statuses[2].is_directory();
+  bool is_system_reg_file = statuses[3].is_regular_file();
+
+  if (is_c_drive_dir)
+  {
+    data.c_drive_location = c_drive_location;
+  }
+  else
+  {
+    data.warnings.push_back("Could not determine C:\\ drive location, for " + machine_location);
+  }
+
+  try
+  {
+    data.last_time_wine_updated = Helper::get_last_wine_updated(prefix_path);
+  }
+  catch (const std::runtime_error& error)
+  {
+    data.warnings.push_back(error.what());
+  }
+
+  // User registry is loaded once for all the registry settings
+  bool is_windows_version_valid = false;
+  try
+  {
+    auto user_reg = Helper::load_registry(Glib::build_filename(prefix_path, "user.reg"));
+    try
+    {
+      data.bit = Helper::parse_windows_bitness(*user_reg, prefix_path);
+    }
+    catch (const std::runtime_error& error)
+    {
+      data.warnings.push_back(error.what());
+    }
+    data.audio_driver = Helper::parse_audio_driver(*user_reg);
+    data.virtual_desktop = Helper::parse_virtual_desktop(*user_reg);
+    try
+    {
+      // System registry is only loaded when the version is not found in the user registry
+      data.windows = Helper::parse_windows_version(*user_reg, prefix_path);
+      is_windows_version_valid = true;
+    }
+    catch (const std::runtime_error& error)
+    {
+      data.warnings.push_back(error.what());
+    }
+  }
+  catch (const std::runtime_error&)
+  {
+    data.warnings.push_back("Could not open user registry file, for " + machine_location);
+  }
+
+  // Same as Helper::get_bottle_status(), without retrieving the Windows version again
+  data.status = is_dosdevices_dir && is_system_reg_file && is_windows_version_valid;
+  return data;
+}
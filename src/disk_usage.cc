@@ -0,0 +1,202 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    disk_usage.cc
+ * \brief   Disk usage of directory trees
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "disk_usage.h"
+#include <algorithm>
+#include <dirent.h>
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <stdexcept>
+#include <unistd.h>
+#include <utility>
+#include <vector>
+
+/**
+ * \brief Cached usage of a single directory, excluding its sub-directories
+ */
+struct DirectoryUsage
+{
+  time_t mtime_sec;                               /*!< Modification time of the directory when it was read */
+  long mtime_nsec;                                /*!< Nanoseconds part of the modification time */
+  std::int64_t entries_usage;                     /*!< Usage of the directory itself, its files and its sub-directory entries */
+  std::vector<std::string> sub_directory_names;   /*!< Sub-directories on the same file system */
+};
+
+static std::mutex directory_usage_cache_mutex;
+static std::map<std::string, DirectoryUsage> directory_usage_cache; /*!< Directory usage by directory path (used by multiple threads) */
+
+/**
+ * \brief Allocated disk space of a file or directory (in bytes)
+ */
+static std::int64_t allocated_size(const struct stat& file_stat)
+{
+  return static_cast<std::int64_t>(file_stat.st_blocks) * 512;
+}
+
+/**
+ * \brief Remove the cached usage of the directory and all its sub-directories (must hold the cache mutex)
+ * \param[in] dir_path Directory path
+ */
+static void erase_cached_tree(const std::string& dir_path)
+{
+  directory_usage_cache.erase(dir_path);
+  std::string sub_path_prefix = dir_path + "/";
+  auto it = directory_usage_cache.lower_bound(sub_path_prefix);
+  while (it != directory_usage_cache.end() && it->first.compare(0, sub_path_prefix.size(), sub_path_prefix) == 0)
+  {
+    it = directory_usage_cache.erase(it);
+  }
+}
+
+/**
+ * \brief Read the entries of a directory (does not follow symlinks)
+ * \param[in] dir_path Directory path
+ * \param[in] dir_stat Status of the directory
+ * \param[out] sub_directories Sub-directories on the same file system, with their status
+ * \return Usage of the directory itself, its files and its sub-directory entries
+ */
+static std::int64_t
+read_directory(const std::string& dir_path, const struct stat& dir_stat, std::vector<std::pair<std::string, struct stat>>& sub_directories)
+{
+  std::int64_t usage = allocated_size(dir_stat);
+  DIR* dir = opendir(dir_path.c_str());
+  if (dir == nullptr)
+    return usage; // No permission, count the directory only
+  int dir_fd = dirfd(dir);
+  while (const struct dirent* entry = readdir(dir))
+  {
+    std::string name = entry->d_name;
+    if (name == "." || name == "..")
+      continue;
+    struct stat entry_stat;
+    if (fstatat(dir_fd, entry->d_name, &entry_stat, AT_SYMLINK_NOFOLLOW) != 0)
+      continue; // Removed in the meantime
+    if (S_ISDIR(entry_stat.st_mode))
+    {
+      // Mounted file systems are not counted (eg. a bind mount)
+      if (entry_stat.st_dev == dir_stat.st_dev)
+        sub_directories.emplace_back(name, entry_stat);
+    }
+    else
+    {
+      usage += allocated_size(entry_stat);
+    }
+  }
+  closedir(dir);
+  return usage;
+}
+
+/// Meyers Singleton
+DiskUsage::DiskUsage() = default;
+/// Destructor
+DiskUsage::~DiskUsage() = default;
+
+/**
+ * \brief Get singleton instance
+ * \return DiskUsage reference (singleton)
+ */
+DiskUsage& DiskUsage::get_instance()
+{
+  static DiskUsage instance;
+  return instance;
+}
+
+/**
+ * \brief Get the disk usage of a directory tree (run this method async), symlinks are not followed and other file systems are skipped.
+ * Can be called from multiple threads at the same time.
+ * \param[in] dir_path Directory path
+ * \throws runtime_error when the directory doesn't exist
+ * \return Allocated disk space in bytes
+ */
+std::int64_t DiskUsage::get_disk_usage(const std::string& dir_path)
+{
+  struct stat dir_stat;
+  if (lstat(dir_path.c_str(), &dir_stat) != 0 || !S_ISDIR(dir_stat.st_mode))
+  {
+    throw std::runtime_error("Could not determine the disk usage of: " + dir_path);
+  }
+  return get_directory_usage(dir_path, dir_stat);
+}
+
+/**
+ * \brief Get the disk usage of a directory tree, unchanged directories are not read again
+ * \param[in] dir_path Directory path
+ * \param[in] dir_stat Status of the directory
+ * \return Allocated disk space in bytes
+ */
+std::int64_t DiskUsage::get_directory_usage(const std::string& dir_path, const struct stat& dir_stat)
+{
+  std::int64_t usage = 0;
+  std::vector<std::pair<std::string, struct stat>> sub_directories;
+  bool is_cached = false;
+  {
+    std::lock_guard<std::mutex> lock(directory_usage_cache_mutex);
+    auto cached = directory_usage_cache.find(dir_path);
+    if (cached != directory_usage_cache.end() && cached->second.mtime_sec == dir_stat.st_mtim.tv_sec &&
+        cached->second.mtime_nsec == dir_stat.st_mtim.tv_nsec)
+    {
+      is_cached = true;
+      usage = cached->second.entries_usage;
+      struct stat unknown_stat = {};
+      for (const std::string& name : cached->second.sub_directory_names)
+      {
+        sub_directories.emplace_back(name, unknown_stat);
+      }
+    }
+  }
+
+  if (is_cached)
+  {
+    // The sub-directories could still be changed, their status is retrieved again
+    std::erase_if(sub_directories, [&dir_path](auto& sub_directory) {
+      std::string sub_path = dir_path + "/" + sub_directory.first;
+      return lstat(sub_path.c_str(), &sub_directory.second) != 0 || !S_ISDIR(sub_directory.second.st_mode);
+    });
+  }
+  else
+  {
+    usage = read_directory(dir_path, dir_stat, sub_directories);
+    DirectoryUsage directory_usage{dir_stat.st_mtim.tv_sec, dir_stat.st_mtim.tv_nsec, usage, {}};
+    for (const auto& sub_directory : sub_directories)
+    {
+      directory_usage.sub_directory_names.push_back(sub_directory.first);
+    }
+    std::lock_guard<std::mutex> lock(directory_usage_cache_mutex);
+    // Forget the removed sub-directories
+    auto previous = directory_usage_cache.find(dir_path);
+    if (previous != directory_usage_cache.end())
+    {
+      for (const std::string& name : previous->second.sub_directory_names)
+      {
+        if (std::find(directory_usage.sub_directory_names.begin(), directory_usage.sub_directory_names.end(), name) ==
+            directory_usage.sub_directory_names.end())
+          erase_cached_tree(dir_path + "/" + name);
+      }
+    }
+    directory_usage_cache.insert_or_assign(dir_path, std::move(directory_usage));
+  }
+
+  for (const auto& sub_directory : sub_directories)
+  {
+    usage += get_directory_usage(dir_path + "/" + sub_directory.first, sub_directory.second);
+  }
+  return usage;
+}
@@ -20,8 +20,11 @@
  */
 #include "general_config_file.h"
 #include <glibmm.h>
+#include <algorithm>
 #include <iostream>
 
+static const int MaxFolderScanDepth = 5; /*!< Maximum number of directory levels to look for bottles */
+
 /// Meyers Singleton
 GeneralConfigFile::GeneralConfigFile() = default;
 /// Destructor
@@ -52,6 +55,9 @@ bool GeneralConfigFile::write_config_file(const GeneralConfigData& general_confi
   try
   {
     keyfile.set_string("General", "DefaultFolder", general_config.default_folder);
+    std::vector<Glib::ustring> additional_folders(general_config.additional_folders.begin(), general_config.additional_folders.end());
+    keyfile.set_string_list("General", "AdditionalFolders", additional_folders);
+    keyfile.set_integer("General", "FolderScanDepth", general_config.folder_scan_depth);
     keyfile.set_boolean("General", "DisplayDefaultWineMachine", general_config.display_default_wine_machine);
     keyfile.set_boolean("General", "PreferWine64", general_config.prefer_wine64);
     keyfile.set_boolean("General", "EnableLoggingStderr", general_config.enable_logging_stderr);
@@ -82,6 +88,7 @@ GeneralConfigData GeneralConfigFile::read_config_file()
   struct GeneralConfigData general_config;
   // Defaults config values
   general_config.default_folder = default_prefix_folder;
+  general_config.folder_scan_depth = 1;
   general_config.display_default_wine_machine = true;
   general_config.prefer_wine64 = false;
   general_config.enable_logging_stderr = true;
@@ -99,6 +106,18 @@ GeneralConfigData GeneralConfigFile::read_config_file()
     {
       keyfile.load_from_file(file_path);
       general_config.default_folder = keyfile.get_string("General", "DefaultFolder");
+      // Optional settings, not available in older config files
+      if (keyfile.has_key("General", "AdditionalFolders"))
+      {
+        std::vector<Glib::ustring> additional_folders = keyfile.get_string_list("General", "AdditionalFolders");
+        for (const Glib::ustring& folder : additional_folders)
+        {
+          if (!folder.empty())
+            general_config.additional_folders.push_back(folder);
+        }
+      }
+      if (keyfile.has_key("General", "FolderScanDepth"))
+        general_config.folder_scan_depth = std::clamp(keyfile.get_integer("General", "FolderScanDepth"), 1, MaxFolderScanDepth);
       general_config.display_default_wine_machine = keyfile.get_boolean("General", "DisplayDefaultWineMachine");
       general_config.prefer_wine64 = keyfile.get_boolean("General", "PreferWine64");
       general_config.enable_logging_stderr = keyfile.get_boolean("General", "EnableLoggingStderr");
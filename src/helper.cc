@@ -19,28 +19,41 @@
  * along with this program.  If not, see <http://www.gnu.org/licenses/>.
  */
 #include "helper.h"
+#include "batch_stat.h"
+#include "log_sink.h"
+#include "process_runner.h"
+#include "reg_escape.h"
+#include "registry_index.h"
 #include "wine_defaults.h"
 #include <algorithm>
 #include <array>
 #include <cstdio>
+#include <cstdlib>
 #include <cstring>
 #include <ctime>
 #include <fcntl.h>
 #include <fstream>
 #include <giomm/file.h>
+#include <glibmm/checksum.h>
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 #include <glibmm/timeval.h>
 #include <iomanip>
 #include <iostream>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <pwd.h>
 #include <regex>
+#include <set>
+#include <sstream>
 #include <stdexcept>
+#include <sys/stat.h>
 #include <sys/types.h>
 #include <time.h>
 #include <tuple>
 #include <unistd.h>
+#include <unordered_map>
 
 std::vector<std::string> wineGuiDirs{Glib::get_home_dir(), ".winegui"}; /*!< WineGui config/storage directory path */
 static string WineGuiDir = Glib::build_path(G_DIR_SEPARATOR_S, wineGuiDirs);
@@ -48,6 +61,8 @@ static string WineGuiDir = Glib::build_path(G_DIR_SEPARATOR_S, wineGuiDirs);
 std::vector<std::string> defaultWineDir{Glib::get_home_dir(), ".wine"}; /*!< Default Wine bottle location */
 static string DefaultBottleWineDir = Glib::build_path(G_DIR_SEPARATOR_S, defaultWineDir);
 
+static const string RegistryCacheDir = Glib::build_filename(WineGuiDir, "cache"); /*!< Registry snapshots location */
+
 // Wine & Winetricks exec
 static const string WineExecutable = "wine";     /*!< Currently expect to be installed globally */
 static const string WineExecutable64 = "wine64"; /*!< Currently expect to be installed globally */
@@ -89,6 +104,33 @@ static const string RegValueDesktop = "\\Desktop\\";
 static const string WineGuiMetaFile = ".winegui.conf";
 static const string UpdateTimestamp = ".update-timestamp";
 
+/**
+ * \brief Cached parsed registry file, only valid as long as the file on disk is not changed
+ */
+struct RegistryCacheEntry
+{
+  dev_t device;
+  ino_t inode;
+  off_t size;
+  struct timespec modified;
+  std::shared_ptr<const RegistryIndex> registry;
+};
+static std::mutex registry_cache_mutex;                               /*!< Protects the registry cache (used by multiple threads) */
+static std::unordered_map<string, RegistryCacheEntry> registry_cache; /*!< Registry file path to parsed registry */
+
+/**
+ * \brief Cached Wine version of a Wine binary, valid as long as the binary is unchanged
+ */
+struct WineVersionCacheEntry
+{
+  time_t mtime_sec;
+  long mtime_nsec;
+  off_t size;
+  string version;
+};
+static std::mutex wine_version_cache_mutex;                        /*!< Protects the Wine version cache (used by multiple threads) */
+static std::map<string, WineVersionCacheEntry> wine_version_cache; /*!< Wine version by real path of the Wine binary */
+
 /**
  * \brief Windows version table to convert Windows version in registry to BottleType Windows enum value.
  *  Source: https://github.com/wine-mirror/wine/blob/master/programs/winecfg/appdefaults.c#L51
@@ -142,27 +184,41 @@ Helper& Helper::get_instance()
  ****************************************************************************/
 
 /**
- * \brief Get the bottle directories within the given path. Depending on the input parameter also add the default Wine bottle (at: ~/.wine).
- * Bottles are sorted alphabetically.
+ * \brief Get the bottle directories within the given path (can take a while on a slow disk, run this method in a thread).
+ * The results of multiple paths are combined by merge_bottles_paths().
  * \param[in] dir_path Path in which we look for the bottles sub-directories
+ * \param[in] depth Number of directory levels to look for bottles, 1 means only the direct sub-directories are bottles.
+ * Deeper sub-directories are only searched when the directory is not a Wine prefix itself.
+ * \return List of the found directories, with their canonical path
+ */
+std::vector<BottlePath> Helper::find_bottles_paths(const string& dir_path, int depth)
+{
+  std::vector<BottlePath> list;
+  find_bottles_paths(dir_path, depth, list);
+  return list;
+}
+
+/**
+ * \brief Combine the bottle directories found in the bottle locations. Depending on the input parameter also add the default Wine bottle
+ * (at: ~/.wine). Bottles found via multiple paths (eg. symlinks) are only listed once, and the bottles are sorted alphabetically.
+ * \param[in] found_paths Bottle directories of each bottle location, see find_bottles_paths()
  * \param[in] display_default_wine_machine If set to true, also add the default Wine bottle to the list of bottle paths
  * \return List of full path (string) of the found directories plus ~/.wine
  */
-std::vector<std::string> Helper::get_bottles_paths(const string& dir_path, bool display_default_wine_machine)
+std::vector<std::string> Helper::merge_bottles_paths(const std::vector<std::vector<BottlePath>>& found_paths, bool display_default_wine_machine)
 {
   std::vector<std::string> list;
-  list.reserve(5);
-  Glib::Dir dir(dir_path);
-  auto name = dir.read_name();
-
-  while (!name.empty())
+  std::set<string> real_paths;
+  auto add_unique_path = [&list, &real_paths](const BottlePath& bottle_path) {
+    if (real_paths.insert(bottle_path.real_path).second)
+      list.push_back(bottle_path.path);
+  };
+  for (const std::vector<BottlePath>& paths : found_paths)
   {
-    auto path = Glib::build_filename(dir_path, name);
-    if (Glib::file_test(path, Glib::FileTest::FILE_TEST_IS_DIR))
+    for (const BottlePath& path : paths)
     {
-      list.push_back(path);
+      add_unique_path(path);
     }
-    name = dir.read_name();
   }
   // Sort alphabetically (case insensitive)
   std::sort(list.begin(), list.end(), Helper::case_insensitive_compare);
@@ -170,7 +226,7 @@ std::vector<std::string> Helper::get_bottles_paths(const string& dir_path, bool
   // Add default wine bottle to the end, if enabled by settings and if directory is present
   if (display_default_wine_machine && dir_exists(DefaultBottleWineDir))
   {
-    list.push_back(DefaultBottleWineDir);
+    add_unique_path(get_bottle_path(DefaultBottleWineDir));
   }
 
   return list;
@@ -178,70 +234,59 @@ std::vector<std::string> Helper::get_bottles_paths(const string& dir_path, bool
 
 /**
  * \brief Run any program with only setting the WINEPREFIX env variable (run this method async).
- * Returns stdout output. Redirect stderr to stdout (2>&1), if you want stderr as well.
+ * The output is written to the log sink while the program is running. Redirect stderr to stdout (2>&1), if you want stderr as well.
  * \param[in] prefix_path The path to wine bottle
  * \param[in] debug_log_level Debug log level
  * \param[in] program Program that gets executed (ideally full path)
+ * \param[in] log_sink Log sink for the terminal output, also flushed when the program is idle
  * \param[in] give_error Inform user when application exit with non-zero exit code
  * \param[in] stderr_output Also output stderr (together with stout)
- * \return Terminal stdout output
  */
-string Helper::run_program(const string& prefix_path, int debug_log_level, const string& program, bool give_error, bool stderr_output)
+void Helper::run_program(const string& prefix_path,
+                         int debug_log_level,
+                         const string& program,
+                         LogSink& log_sink,
+                         bool give_error,
+                         bool stderr_output)
 {
-  string output;
-
   string debug = (debug_log_level != 1) ? "WINEDEBUG=" + Helper::log_level_to_winedebug_string(debug_log_level) + " " : "";
   string exec_program = (stderr_output) ? program + " 2>&1" : program;
   string command = debug + "WINEPREFIX=\"" + prefix_path + "\" " + exec_program;
-  if (give_error)
-  {
-    // Execute the command that also shows an error message to the user when exit code is non-zero
-    output = exec_error_message(command.c_str());
-  }
-  else
+  ProcessOptions options;
+  // Output of a program that stops writing (eg. hangs after a crash) isn't kept in memory
+  options.idle_timeout = LogSink::FlushInterval;
+  options.idle_callback = [&log_sink] { log_sink.flush(); };
+  int exit_code = ProcessRunner::run({"/bin/sh", "-c", command}, [&log_sink](std::string_view output) { log_sink.write(output); }, options);
+  if (give_error && exit_code != 0)
   {
-    // No error message when exit code is non-zero, but we can still return the output and log to disk (if logging is enabled)
-    output = exec(command.c_str());
+    // Dispatcher will run the connected slot in the main loop,
+    // instead of the same context/thread in case of a signal.emit() call.
+    // Signal error message to the user:
+    Helper::get_instance().failure_on_exec.emit();
   }
-  return output;
 }
 
 /**
  * \brief Run a Windows program under Wine (run this method async).
- * Returns stdout output. Redirect stderr to stdout (2>&1), if you want stderr as well.
+ * The output is written to the log sink while the program is running. Redirect stderr to stdout (2>&1), if you want stderr as well.
  * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary
  * \param[in] prefix_path The path to bottle wine
  * \param[in] debug_log_level Debug log level
  * \param[in] program Program/executable that will be executed (be sure your application executable is between
  * brackets in case of spaces)
+ * \param[in] log_sink Log sink for the terminal output
  * \param[in] give_error Inform user when application exit with non-zero exit code
  * \param[in] stderr_output Also output stderr (together with stout)
- * \return Terminal stdout output
  */
-string Helper::run_program_under_wine(
-    bool wine_64_bit, const string& prefix_path, int debug_log_level, const string& program, bool give_error, bool stderr_output)
+void Helper::run_program_under_wine(bool wine_64_bit,
+                                    const string& prefix_path,
+                                    int debug_log_level,
+                                    const string& program,
+                                    LogSink& log_sink,
+                                    bool give_error,
+                                    bool stderr_output)
 {
-  return run_program(prefix_path, debug_log_level, Helper::get_wine_executable_location(wine_64_bit) + " " + program, give_error, stderr_output);
-}
-
-/**
- * \brief Write/append logging to WineGUI log file
- * \param logging_bottle_prefix Wine Bottle prefix location
- * \param logging Logging data
- */
-void Helper::write_to_log_file(const string& logging_bottle_prefix, const string& logging)
-{
-  string log_path = Helper::get_log_file_path(logging_bottle_prefix);
-  auto file = Gio::File::create_for_path(log_path);
-  try
-  {
-    auto output = file->append_to(Gio::FileCreateFlags::FILE_CREATE_NONE);
-    output->write(logging);
-  }
-  catch (const Glib::Error& ex)
-  {
-    std::cout << "Error: Couldn't write debug logging to log file. Error " << ex.what() << std::endl;
-  }
+  run_program(prefix_path, debug_log_level, Helper::get_wine_executable_location(wine_64_bit) + " " + program, log_sink, give_error, stderr_output);
 }
 
 /**
@@ -259,50 +304,37 @@ string Helper::get_log_file_path(const string& logging_bottle_prefix)
  */
 void Helper::wait_until_wineserver_is_terminated(const string& prefix_path)
 {
-  string exit_code = exec(("WINEPREFIX=\"" + prefix_path + "\" timeout 60 wineserver -w; echo $?").c_str());
-  if (exit_code == "124")
+  try
+  {
+    ProcessOptions options;
+    options.environment.push_back("WINEPREFIX=" + prefix_path);
+    options.discard_output = true;
+    if (ProcessRunner::run({"timeout", "60", "wineserver", "-w"}, options).exit_code == 124)
+    {
+      std::cout << "Time-out of wineserver wait command triggered (wineserver is still running..)" << std::endl;
+    }
+  }
+  catch (const std::runtime_error& error)
   {
-    std::cout << "Time-out of wineserver wait command triggered (wineserver is still running..)" << std::endl;
+    std::cerr << "Error: " << error.what() << std::endl;
   }
 }
 
 /**
- * \brief Determine which type of wine executable to use
+ * \brief Determine which type of wine executable to use (searched in PATH, without starting a shell)
  * \return -1 on failure, 0 on 32-bit, 1 on 64-bit wine executable
  */
 int Helper::determine_wine_executable()
 {
-  int return_status = -2;
-  // Try wine 32-bit
-  string output32 = exec(("command -v " + Helper::get_wine_executable_location(false) + " >/dev/null 2>&1; echo $?").c_str());
-  if (!output32.empty())
-  {
-    // Remove new lines
-    output32.erase(std::remove(output32.begin(), output32.end(), '\n'), output32.end());
-    if (output32.compare("0") == 0)
-    {
-      return_status = 0;
-    }
-  }
-  // Try wine 64-bit
-  if (return_status == -2)
+  if (!Glib::find_program_in_path(Helper::get_wine_executable_location(false)).empty())
   {
-    string output64 = exec(("command -v " + Helper::get_wine_executable_location(true) + " >/dev/null 2>&1; echo $?").c_str());
-    if (!output64.empty())
-    {
-      // Remove new lines
-      output64.erase(std::remove(output64.begin(), output64.end(), '\n'), output64.end());
-      if (output64.compare("0") == 0)
-      {
-        return_status = 1;
-      }
-    }
+    return 0;
   }
-  if (return_status == -2)
+  if (!Glib::find_program_in_path(Helper::get_wine_executable_location(true)).empty())
   {
-    return_status = -1;
+    return 1;
   }
-  return return_status;
+  return -1;
 }
 
 /**
@@ -341,14 +373,34 @@ string Helper::get_winetricks_location()
 }
 
 /**
- * \brief Get Wine version from CLI
+ * \brief Get Wine version from CLI. The version is cached, Wine is only started again when the Wine binary is changed (eg. upgraded)
  * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary
  * \throws runtime_error we could not determine Wine version
  * \return Return the wine version
  */
 string Helper::get_wine_version(bool wine_64_bit)
 {
-  string output = exec((Helper::get_wine_executable_location(wine_64_bit) + " --version").c_str());
+  string binary_path = Glib::find_program_in_path(Helper::get_wine_executable_location(wine_64_bit));
+  if (binary_path.empty())
+  {
+    throw std::runtime_error("Could not receive Wine version!\n\nIs Wine installed?");
+  }
+  // Cache is keyed on the real path (wine is often a symlink to the actual binary)
+  std::unique_ptr<char, decltype(&free)> real_path(realpath(binary_path.c_str(), nullptr), &free);
+  struct stat binary_stat;
+  bool is_cacheable = (real_path != nullptr && stat(real_path.get(), &binary_stat) == 0);
+  if (is_cacheable)
+  {
+    std::lock_guard<std::mutex> lock(wine_version_cache_mutex);
+    auto cached = wine_version_cache.find(real_path.get());
+    if (cached != wine_version_cache.end() && cached->second.mtime_sec == binary_stat.st_mtim.tv_sec &&
+        cached->second.mtime_nsec == binary_stat.st_mtim.tv_nsec && cached->second.size == binary_stat.st_size)
+    {
+      return cached->second.version;
+    }
+  }
+
+  string output = ProcessRunner::run({binary_path, "--version"}).output;
   if (!output.empty())
   {
     std::vector<string> results = split(output, '-');
@@ -361,6 +413,12 @@ string Helper::get_wine_version(bool wine_64_bit)
         string version = results2.at(0); // just only get the version number (eg. 6.0)
         // Remove new lines
         version.erase(std::remove(version.begin(), version.end(), '\n'), version.end());
+        if (is_cacheable)
+        {
+          std::lock_guard<std::mutex> lock(wine_version_cache_mutex);
+          wine_version_cache.insert_or_assign(real_path.get(), WineVersionCacheEntry{binary_stat.st_mtim.tv_sec, binary_stat.st_mtim.tv_nsec,
+                                                                                     binary_stat.st_size, version});
+        }
         return version;
       }
       else
@@ -416,35 +474,40 @@ string Helper::open_file_from_uri(const string& uri)
  */
 void Helper::create_wine_bottle(bool wine_64_bit, const string& prefix_path, BottleTypes::Bit bit, const bool disable_gecko_mono)
 {
-  string wine_arch = "";
+  ProcessOptions options;
+  options.discard_output = true;
+  options.environment.push_back("WINEPREFIX=" + prefix_path);
   switch (bit)
   {
   case BottleTypes::Bit::win32:
-    wine_arch = " WINEARCH=win32";
+    options.environment.push_back("WINEARCH=win32");
     break;
   case BottleTypes::Bit::win64:
-    wine_arch = " WINEARCH=win64";
+    options.environment.push_back("WINEARCH=win64");
     break;
   }
-  string wine_dll_overrides = (disable_gecko_mono) ? " WINEDLLOVERRIDES=\"mscoree=d;mshtml=d\"" : "";
-  string wine_command =
-      "WINEPREFIX=\"" + prefix_path + "\"" + wine_arch + wine_dll_overrides + " " + Helper::get_wine_executable_location(wine_64_bit) + " wineboot";
-  string command = wine_command + ">/dev/null 2>&1; echo $?";
-  string output = exec(command.c_str());
-  if (!output.empty())
+  if (disable_gecko_mono)
+    options.environment.push_back("WINEDLLOVERRIDES=mscoree=d;mshtml=d");
+  string wine = Helper::get_wine_executable_location(wine_64_bit);
+  string wine_command = "";
+  for (const string& variable : options.environment)
   {
-    // Remove new lines
-    output.erase(std::remove(output.begin(), output.end(), '\n'), output.end());
-    if (!(output.compare("0") == 0))
-    {
-      throw std::runtime_error("Something went wrong when creating a new Windows machine. Wine prefix: " + get_folder_name(prefix_path) +
-                               "\n\nCommand executed: " + wine_command + "\nFull path location: " + prefix_path);
-    }
+    wine_command += variable + " ";
   }
-  else
+  wine_command += wine + " wineboot";
+  int exit_code = -1;
+  try
+  {
+    exit_code = ProcessRunner::run({wine, "wineboot"}, options).exit_code;
+  }
+  catch (const std::runtime_error&)
+  {
+    // Same error message as a failed wineboot
+  }
+  if (exit_code != 0)
   {
     throw std::runtime_error("Something went wrong when creating a new Windows machine. Wine prefix: " + get_folder_name(prefix_path) +
-                             "\n\nCommand executed: " + wine_command + "\nFull location: " + prefix_path);
+                             "\n\nCommand executed: " + wine_command + "\nFull path location: " + prefix_path);
   }
 }
 
@@ -457,20 +520,9 @@ void Helper::remove_wine_bottle(const string& prefix_path)
 {
   if (Helper::dir_exists(prefix_path))
   {
-    string output = exec(("rm -rf \"" + prefix_path + "\"; echo $?").c_str());
-    if (!output.empty())
-    {
-      // Remove new lines
-      output.erase(std::remove(output.begin(), output.end(), '\n'), output.end());
-      if (!(output.compare("0") == 0))
-      {
-        throw std::runtime_error("Something went wrong when removing the Windows Machine. Wine machine: " + get_folder_name(prefix_path) +
-                                 "\n\nFull path location: " + prefix_path);
-      }
-    }
-    else
+    if (ProcessRunner::run({"rm", "-rf", "--", prefix_path}).exit_code != 0)
     {
-      throw std::runtime_error("Could not remove Windows Machine, no result. Wine machine: " + get_folder_name(prefix_path) +
+      throw std::runtime_error("Something went wrong when removing the Windows Machine. Wine machine: " + get_folder_name(prefix_path) +
                                "\n\nFull path location: " + prefix_path);
     }
   }
@@ -491,20 +543,9 @@ void Helper::rename_wine_bottle_folder(const string& current_prefix_path, const
 {
   if (Helper::dir_exists(current_prefix_path))
   {
-    string output = exec(("mv \"" + current_prefix_path + "\" \"" + new_prefix_path + "\"; echo $?").c_str());
-    if (!output.empty())
-    {
-      // Remove new lines
-      output.erase(std::remove(output.begin(), output.end(), '\n'), output.end());
-      if (!(output.compare("0") == 0))
-      {
-        throw std::runtime_error("Something went wrong when renaming the Windows Machine. Wine machine: " + get_folder_name(current_prefix_path) +
-                                 "\n\nCurrent full path location: " + current_prefix_path + ". Tried to rename to: " + new_prefix_path);
-      }
-    }
-    else
+    if (ProcessRunner::run({"mv", "-T", "--", current_prefix_path, new_prefix_path}).exit_code != 0)
     {
-      throw std::runtime_error("Could not rename Windows Machine, no result. Current Wine machine: " + get_folder_name(current_prefix_path) +
+      throw std::runtime_error("Something went wrong when renaming the Windows Machine. Wine machine: " + get_folder_name(current_prefix_path) +
                                "\n\nCurrent full path location: " + current_prefix_path + ". Tried to rename to: " + new_prefix_path);
     }
   }
@@ -534,122 +575,8 @@ string Helper::get_folder_name(const string& prefix_path)
  */
 BottleTypes::Windows Helper::get_windows_version(const string& prefix_path)
 {
-  // Trying user registry first
-  string user_reg_file_path = Glib::build_filename(prefix_path, UserReg);
-
-  string win_version = Helper::get_reg_value(user_reg_file_path, RegKeyWine, RegNameWindowsVersion);
-  if (!win_version.empty())
-  {
-    for (unsigned int i = 0; i < BottleTypes::WindowsEnumSize; i++)
-    {
-      // Check if Windows version matches the win_version string
-      if (((WindowsVersions[i].version).compare(win_version) == 0))
-      {
-        return WindowsVersions[i].windows;
-      }
-    }
-  }
-
-  // Trying system registry
-  string system_reg_file_path = Glib::build_filename(prefix_path, SystemReg);
-  string version = "";
-  if (!(version = Helper::get_reg_value(system_reg_file_path, RegKeyNameNT, RegNameNTVersion)).empty())
-  {
-    string build_number_nt = Helper::get_reg_value(system_reg_file_path, RegKeyNameNT, RegNameNTBuildNumber);
-    string type_nt = Helper::get_reg_value(system_reg_file_path, RegKeyType, RegNameProductType);
-    // Find the correct Windows version, comparing the version, build number and NT type (if present)
-    for (unsigned int i = 0; i < BottleTypes::WindowsEnumSize; i++)
-    {
-      // Check if version + build number matches
-      if (((WindowsVersions[i].versionNumber).compare(version) == 0) && ((WindowsVersions[i].buildNumber).compare(build_number_nt) == 0))
-      {
-        if (!type_nt.empty())
-        {
-          if ((WindowsVersions[i].productType).compare(type_nt) == 0)
-          {
-            return WindowsVersions[i].windows;
-          }
-        }
-        else
-        {
-          return WindowsVersions[i].windows;
-        }
-      }
-
-      // Fall-back - return the Windows version based on build NT number, even if the version number doesn't exactly match
-      for (unsigned int x = 0; x < BottleTypes::WindowsEnumSize; x++)
-      {
-        // Check if build number matches
-        if ((WindowsVersions[x].buildNumber).compare(build_number_nt) == 0)
-        {
-          if (!type_nt.empty())
-          {
-            if ((WindowsVersions[x].productType).compare(type_nt) == 0)
-            {
-              return WindowsVersions[x].windows;
-            }
-          }
-        }
-      }
-    }
-
-    // Fall-back of fall-back - return the Windows version based on version number, even if the build NT number doesn't exactly match
-    for (unsigned int y = 0; y < BottleTypes::WindowsEnumSize; y++)
-    {
-      // Check if version matches
-      if ((WindowsVersions[y].versionNumber).compare(version) == 0)
-      {
-        if (!type_nt.empty())
-        {
-          if ((WindowsVersions[y].productType).compare(type_nt) == 0)
-          {
-            return WindowsVersions[y].windows;
-          }
-        }
-        else
-        {
-          return WindowsVersions[y].windows;
-        }
-      }
-    }
-  }
-  else if (!(version = Helper::get_reg_value(system_reg_file_path, RegKeyName9x, RegName9xVersion)).empty())
-  {
-    string current_version = "";
-    string current_build_number = "";
-    std::vector<string> version_list = split(version, '.');
-    // Only get minor & major
-    if (sizeof(version_list) >= 2)
-    {
-      current_version = version_list.at(0) + '.' + version_list.at(1);
-    }
-    // Get build number
-    if (sizeof(version_list) >= 3)
-    {
-      current_build_number = version_list.at(2);
-    }
-
-    // Find Windows version
-    for (unsigned int i = 0; i < BottleTypes::WindowsEnumSize; i++)
-    {
-      // Check if version + build number matches
-      if (((WindowsVersions[i].versionNumber).compare(current_version) == 0) && ((WindowsVersions[i].buildNumber).compare(current_build_number) == 0))
-      {
-        return WindowsVersions[i].windows;
-      }
-    }
-
-    // Fall-back to default Windows version, even if the build number doesn't match
-    return WineDefaults::WindowsOs;
-  }
-  else
-  {
-    throw std::runtime_error("Could not determine Windows version, we assume " + BottleTypes::to_string(WineDefaults::WindowsOs) +
-                             ". Wine machine: " + get_folder_name(prefix_path) + "\n\nFull location: " + prefix_path);
-  }
-  // Function didn't return before (meaning no match found)
-  throw std::runtime_error("Could not determine Windows version, we assume " + BottleTypes::to_string(WineDefaults::WindowsOs) +
-                           ". Wine machine: " + get_folder_name(prefix_path) + "\n\nFull location: " + prefix_path);
+  auto user_reg = load_registry(Glib::build_filename(prefix_path, UserReg));
+  return parse_windows_version(*user_reg, prefix_path);
 }
 
 /**
@@ -660,31 +587,8 @@ BottleTypes::Windows Helper::get_windows_version(const string& prefix_path)
  */
 BottleTypes::Bit Helper::get_windows_bitness(const string& prefix_path)
 {
-  string file_path = Glib::build_filename(prefix_path, UserReg);
-
-  string meta_value_name = "arch";
-  string value = Helper::Helper::get_reg_meta_data(file_path, meta_value_name);
-  if (!value.empty())
-  {
-    if (value.compare("win32") == 0)
-    {
-      return BottleTypes::Bit::win32;
-    }
-    else if (value.compare("win64") == 0)
-    {
-      return BottleTypes::Bit::win64;
-    }
-    else
-    {
-      throw std::runtime_error("Could not determine Windows system bit (not win32 and not win64, value: " + value +
-                               "), for Wine machine: " + get_folder_name(prefix_path) + "\n\nFull location: " + prefix_path);
-    }
-  }
-  else
-  {
-    throw std::runtime_error("Could not determine Windows system bit, for Wine machine: " + get_folder_name(prefix_path) +
-                             "\n\nFull location: " + prefix_path);
-  }
+  auto user_reg = load_registry(Glib::build_filename(prefix_path, UserReg));
+  return parse_windows_bitness(*user_reg, prefix_path);
 }
 
 /**
@@ -695,41 +599,8 @@ BottleTypes::Bit Helper::get_windows_bitness(const string& prefix_path)
  */
 BottleTypes::AudioDriver Helper::get_audio_driver(const string& prefix_path)
 {
-  string file_path = Glib::build_filename(prefix_path, UserReg);
-  string value = Helper::get_reg_value(file_path, RegKeyAudio, RegNameAudio);
-  if (!value.empty())
-  {
-    if (value.compare("pulse") == 0)
-    {
-      return BottleTypes::AudioDriver::pulseaudio;
-    }
-    else if (value.compare("alsa") == 0)
-    {
-      return BottleTypes::AudioDriver::alsa;
-    }
-    else if (value.compare("oss") == 0)
-    {
-      return BottleTypes::AudioDriver::oss;
-    }
-    else if (value.compare("coreaudio") == 0)
-    {
-      return BottleTypes::AudioDriver::coreaudio;
-    }
-    else if (value.compare("disabled") == 0)
-    {
-      return BottleTypes::AudioDriver::disabled;
-    }
-    else
-    {
-      // Otherwise just return PulseAudio
-      return BottleTypes::AudioDriver::pulseaudio;
-    }
-  }
-  else
-  {
-    // If not found, it is set to PulseAudio
-    return BottleTypes::AudioDriver::pulseaudio;
-  }
+  auto user_reg = load_registry(Glib::build_filename(prefix_path, UserReg));
+  return parse_audio_driver(*user_reg);
 }
 
 /**
@@ -740,21 +611,8 @@ BottleTypes::AudioDriver Helper::get_audio_driver(const string& prefix_path)
  */
 string Helper::get_virtual_desktop(const string& prefix_path)
 {
-  string file_path = Glib::build_filename(prefix_path, UserReg);
-  // Check if emulate desktop is enabled. Eg. "Desktop"="Default"
-  string emulate_desktop_value = Helper::get_reg_value(file_path, RegKeyVirtualDesktop, RegNameVirtualDesktop);
-  string resolution;
-  if (!emulate_desktop_value.empty())
-  {
-    // The resolution can be found in Key: Software\\Wine\\Explorer\\Desktops with the Value name set as value
-    // (see above, "Default" is the default value). eg. "Default"="1024x768"
-    string resolution_value = Helper::get_reg_value(file_path, RegKeyVirtualDesktopResolution, RegNameVirtualDesktopDefault);
-    if (!resolution_value.empty())
-    {
-      resolution = resolution_value;
-    }
-  }
-  return resolution;
+  auto user_reg = load_registry(Glib::build_filename(prefix_path, UserReg));
+  return parse_virtual_desktop(*user_reg);
 }
 
 /**
@@ -773,8 +631,10 @@ string Helper::get_last_wine_updated(const string& prefix_path)
     if (!epoch_time.empty())
     {
       time_t secsSinceEpoch = strtoul(epoch_time.c_str(), NULL, 0);
+      struct tm local_time; // Thread-safe localtime_r(), since the bottles are retrieved in parallel
+      localtime_r(&secsSinceEpoch, &local_time);
       std::stringstream stringStream;
-      stringStream << std::put_time(localtime(&secsSinceEpoch), "%c");
+      stringStream << std::put_time(&local_time, "%c");
       return stringStream.str();
     }
     else
@@ -800,8 +660,10 @@ bool Helper::get_bottle_status(const string& prefix_path)
 {
   // Check if some directories exists, and system registry file,
   // and finally, if we can read-out the Windows OS version without errors
-  if (Helper::dir_exists(prefix_path) && Helper::dir_exists(Glib::build_filename(prefix_path, "dosdevices")) &&
-      Helper::file_exists(Glib::build_filename(prefix_path, SystemReg)))
+  // All the lookups are done at once
+  std::vector<FileStatus> statuses =
+      BatchStat::stat_files({prefix_path, Glib::build_filename(prefix_path, "dosdevices"), Glib::build_filename(prefix_path, SystemReg)});
+  if (statuses[0].is_directory() && statuses[1].is_directory() && statuses[2].is_regular_file())
   {
     try
     {
@@ -969,7 +831,8 @@ string Helper::get_c_letter_drive(const string& prefix_path)
 {
   // Determ C location
   string c_drive_location = Glib::build_filename(prefix_path, "dosdevices", "c:");
-  if (Helper::dir_exists(prefix_path) && Helper::dir_exists(c_drive_location))
+  std::vector<FileStatus> statuses = BatchStat::stat_files({prefix_path, c_drive_location});
+  if (statuses[0].is_directory() && statuses[1].is_directory())
   {
     return c_drive_location;
   }
@@ -1047,16 +910,9 @@ void Helper::self_update_winetricks()
 {
   if (file_exists(WinetricksExecutable))
   {
-    string output = exec((WinetricksExecutable + " --self-update >/dev/null 2>&1; echo $?").c_str());
-    if (!output.empty())
-    {
-      output.erase(std::remove(output.begin(), output.end(), '\n'), output.end());
-      if (output.compare("0") != 0)
-      {
-        throw std::invalid_argument("Could not update Winetricks, keep using the v" + Helper::get_winetricks_version());
-      }
-    }
-    else
+    ProcessOptions options;
+    options.discard_output = true;
+    if (ProcessRunner::run({WinetricksExecutable, "--self-update"}, options).exit_code != 0)
     {
       throw std::invalid_argument("Could not update Winetricks, keep using the v" + Helper::get_winetricks_version());
     }
@@ -1068,133 +924,116 @@ void Helper::self_update_winetricks()
 }
 
 /**
- * \brief Set Windows OS version by using Winetricks
+ * \brief Set Windows OS version, by changing the Wine version in the registry
+ * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary (only used when wineserver is running)
  * \param[in] prefix_path Bottle prefix
  * \param[in] windows Windows version (enum)
  * \throws runtime_error when we could not set the Windows OS version
  */
-void Helper::set_windows_version(const string& prefix_path, BottleTypes::Windows windows)
+void Helper::set_windows_version(bool wine_64_bit, const string& prefix_path, BottleTypes::Windows windows)
 {
-  if (file_exists(WinetricksExecutable))
+  bool is_64_bit = (get_windows_bitness(prefix_path) == BottleTypes::Bit::win64);
+  for (const auto& windows_version : WindowsVersions)
   {
-    string win = BottleTypes::get_winetricks_string(windows);
-    string output = exec(("WINEPREFIX=\"" + prefix_path + "\" " + WinetricksExecutable + " " + win + ">/dev/null 2>&1; echo $?").c_str());
-    if (!output.empty())
+    // Windows XP has a different version string for 64-bit
+    if (windows_version.windows == windows && (windows_version.version != "winxp64" || is_64_bit))
     {
-      output.erase(std::remove(output.begin(), output.end(), '\n'), output.end());
-      if (output.compare("0") != 0)
+      try
       {
-        throw std::runtime_error("Could not set Windows OS version");
+        set_reg_value(wine_64_bit, prefix_path, UserReg, RegKeyWine, RegNameWindowsVersion, windows_version.version);
       }
-    }
-    else
-    {
-      throw std::runtime_error("Could not set Windows OS version");
+      catch (const std::runtime_error& error)
+      {
+        throw std::runtime_error("Could not set Windows OS version\n" + string(error.what()));
+      }
+      return;
     }
   }
+  throw std::runtime_error("Could not set Windows OS version (unknown version)");
 }
 
 /**
- * \brief Set custom virtual desktop resolution by using Winetricks
+ * \brief Set custom virtual desktop resolution, by changing the Explorer desktop settings in the registry
+ * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary (only used when wineserver is running)
  * \param[in] prefix_path Bottle prefix
  * \param[in] resolution New screen resolution (eg. 1920x1080)
  * \throws runtime_error when we could not set the virtual desktop resolution
  */
-void Helper::set_virtual_desktop(const string& prefix_path, string resolution)
+void Helper::set_virtual_desktop(bool wine_64_bit, const string& prefix_path, string resolution)
 {
-  if (file_exists(WinetricksExecutable))
+  std::vector<string> res = split(resolution, 'x');
+  if (res.size() >= 2)
   {
-    std::vector<string> res = split(resolution, 'x');
-    if (res.size() >= 2)
+    int x = 0, y = 0;
+    try
     {
-      int x = 0, y = 0;
-      try
-      {
-        x = std::atoi(res.at(0).c_str());
-        y = std::atoi(res.at(1).c_str());
-      }
-      catch (std::exception const& e)
-      {
-        throw std::runtime_error("Could not set virtual desktop resolution (invalid input)");
-      }
+      x = std::atoi(res.at(0).c_str());
+      y = std::atoi(res.at(1).c_str());
+    }
+    catch (std::exception const& e)
+    {
+      throw std::runtime_error("Could not set virtual desktop resolution (invalid input)");
+    }
 
-      if (x < 640 || y < 480)
-      {
-        // Set to minimum resolution
-        resolution = "640x480";
-      }
+    if (x < 640 || y < 480)
+    {
+      // Set to minimum resolution
+      resolution = "640x480";
+    }
 
-      string output = exec(("WINEPREFIX=\"" + prefix_path + "\" " + WinetricksExecutable + " vd=" + resolution + ">/dev/null 2>&1; echo $?").c_str());
-      if (!output.empty())
-      {
-        output.erase(std::remove(output.begin(), output.end(), '\n'), output.end());
-        if (output.compare("0") != 0)
-        {
-          throw std::runtime_error("Could not set virtual desktop resolution");
-        }
-      }
-      else
-      {
-        throw std::runtime_error("Could not set virtual desktop resolution");
-      }
+    try
+    {
+      set_reg_value(wine_64_bit, prefix_path, UserReg, RegKeyVirtualDesktop, RegNameVirtualDesktop, RegNameVirtualDesktopDefault);
+      set_reg_value(wine_64_bit, prefix_path, UserReg, RegKeyVirtualDesktopResolution, RegNameVirtualDesktopDefault, resolution);
     }
-    else
+    catch (const std::runtime_error& error)
     {
-      throw std::runtime_error("Could not set virtual desktop resolution (invalid input)");
+      throw std::runtime_error("Could not set virtual desktop resolution\n" + string(error.what()));
     }
   }
+  else
+  {
+    throw std::runtime_error("Could not set virtual desktop resolution (invalid input)");
+  }
 }
 
 /**
- * \brief Disable Virtual Desktop fully by using Winetricks
+ * \brief Disable Virtual Desktop fully, by removing the Explorer desktop settings from the registry
+ * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary (only used when wineserver is running)
  * \param[in] prefix_path Bottle prefix
  * \throws runtime_error when we could not disable the virtual desktop
  */
-void Helper::disable_virtual_desktop(const string& prefix_path)
+void Helper::disable_virtual_desktop(bool wine_64_bit, const string& prefix_path)
 {
-  if (file_exists(WinetricksExecutable))
+  try
   {
-    string output = exec(("WINEPREFIX=\"" + prefix_path + "\" " + WinetricksExecutable + " vd=off>/dev/null 2>&1; echo $?").c_str());
-    if (!output.empty())
-    {
-      output.erase(std::remove(output.begin(), output.end(), '\n'), output.end());
-      if (output.compare("0") != 0)
-      {
-        throw std::runtime_error("Could not Disable Virtual Desktop");
-      }
-    }
-    else
-    {
-      throw std::runtime_error("Could not Disable Virtual Desktop");
-    }
+    delete_reg_value(wine_64_bit, prefix_path, UserReg, RegKeyVirtualDesktop, RegNameVirtualDesktop);
+    delete_reg_value(wine_64_bit, prefix_path, UserReg, RegKeyVirtualDesktopResolution, RegNameVirtualDesktopDefault);
+  }
+  catch (const std::runtime_error& error)
+  {
+    throw std::runtime_error("Could not Disable Virtual Desktop\n" + string(error.what()));
   }
 }
 
 /**
- * \brief Set Audio Driver by using Winetricks
+ * \brief Set Audio Driver, by changing the Wine drivers setting in the registry
+ * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary (only used when wineserver is running)
  * \param[in] prefix_path Bottle prefix
  * \param[in] audio_driver Audio driver to be set
  * \throws runtime_error when we could not set the auditor driver
  */
-void Helper::set_audio_driver(const string& prefix_path, BottleTypes::AudioDriver audio_driver)
+void Helper::set_audio_driver(bool wine_64_bit, const string& prefix_path, BottleTypes::AudioDriver audio_driver)
 {
-  if (file_exists(WinetricksExecutable))
+  // Same driver names as Winetricks, except disabled audio is an empty string
+  string audio = (audio_driver != BottleTypes::AudioDriver::disabled) ? BottleTypes::get_winetricks_string(audio_driver) : "";
+  try
   {
-    string audio = BottleTypes::get_winetricks_string(audio_driver);
-    //
-    string output = exec(("WINEPREFIX=\"" + prefix_path + "\" " + WinetricksExecutable + " sound=" + audio + ">/dev/null 2>&1; echo $?").c_str());
-    if (!output.empty())
-    {
-      output.erase(std::remove(output.begin(), output.end(), '\n'), output.end());
-      if (output.compare("0") != 0)
-      {
-        throw std::runtime_error("Could not set Audio driver");
-      }
-    }
-    else
-    {
-      throw std::runtime_error("Could not set Audio driver");
-    }
+    set_reg_value(wine_64_bit, prefix_path, UserReg, RegKeyAudio, RegNameAudio, audio);
+  }
+  catch (const std::runtime_error& error)
+  {
+    throw std::runtime_error("Could not set Audio driver\n" + string(error.what()));
   }
 }
 
@@ -1494,76 +1333,68 @@ string Helper::string_to_icon(const std::string& string)
  ****************************************************************************/
 
 /**
- * \brief Execute command on terminal. Returns stdout output. Redirect stderr to stdout (2>&1), if you want stderr as well.
- * \param[in] cmd The command to be executed
- * \throws runtime_error when popen failed (empty pipe pointer)
- * \return Terminal stdout output
+ * \brief Look for the bottle directories within the given path (recursively up to the given depth)
+ * \param[in] dir_path Path in which we look for the bottles sub-directories
+ * \param[in] depth Number of directory levels to look for bottles
+ * \param[in,out] list Found bottle directories are added to this list
  */
-string Helper::exec(const char* cmd)
+void Helper::find_bottles_paths(const string& dir_path, int depth, std::vector<BottlePath>& list)
 {
-  // Max 128 characters
-  std::array<char, 128> buffer;
-  string output = "";
-
-  // Execute command using popen,
-  // And use the standard C pclose method during stream closure.
-  std::unique_ptr<FILE, decltype(&pclose)> pipe(popen(cmd, "r"), &pclose);
-  if (!pipe)
+  try
   {
-    throw std::runtime_error("popen() failed!");
+    Glib::Dir dir(dir_path);
+    auto name = dir.read_name();
+    while (!name.empty())
+    {
+      auto path = Glib::build_filename(dir_path, name);
+      if (Glib::file_test(path, Glib::FileTest::FILE_TEST_IS_DIR))
+      {
+        // Directories at the deepest level are always listed (also bottles that are not created completely)
+        if (depth <= 1 || is_wine_prefix(path))
+          list.push_back(get_bottle_path(path));
+        else
+          find_bottles_paths(path, depth - 1, list);
+      }
+      name = dir.read_name();
+    }
   }
-  while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr)
+  catch (const Glib::FileError& error)
   {
-    output += buffer.data();
+    std::cerr << "WARN: Could not look for bottles in " << dir_path << ": " << error.what() << std::endl;
   }
-  return output;
 }
 
 /**
- * \brief Execute command on terminal, give user an error message when exit code is non-zero.
- * Returns stdout output. Redirect stderr to stdout (2>&1), if you want stderr as well.
- * \param[in] cmd The command to be executed
- * \throws runtime_error when popen failed (empty pipe pointer)
- * \return Terminal stdout output
+ * \brief Get the canonical path of a bottle directory
+ * \param[in] path Bottle directory
+ * \return Bottle path, the canonical path is the path itself when it can't be resolved
  */
-string Helper::exec_error_message(const char* cmd)
+BottlePath Helper::get_bottle_path(const string& path)
 {
-  // Max 128 characters
-  std::array<char, 128> buffer;
-  string output = "";
+  std::unique_ptr<char, decltype(&free)> real_path(realpath(path.c_str(), nullptr), &free);
+  return {path, (real_path != nullptr) ? string(real_path.get()) : path};
+}
 
-  // Execute command using popen
-  // Use a custom close file function during the pipe close (close_exec_stream method, see below)
-  std::unique_ptr<FILE, decltype(&close_exec_stream)> pipe(popen(cmd, "r"), &close_exec_stream);
-  if (!pipe)
-  {
-    throw std::runtime_error("popen() failed!");
-  }
-  while (fgets(buffer.data(), buffer.size(), pipe.get()) != nullptr)
-  {
-    output += buffer.data();
-  }
-  return output;
+/**
+ * \brief Check if the directory is a Wine prefix (contains a system registry file or DOS devices)
+ * \param[in] dir_path Directory path
+ * \return True if the directory is a Wine prefix
+ */
+bool Helper::is_wine_prefix(const string& dir_path)
+{
+  return Glib::file_test(Glib::build_filename(dir_path, SystemReg), Glib::FileTest::FILE_TEST_IS_REGULAR) ||
+         Glib::file_test(Glib::build_filename(dir_path, "dosdevices"), Glib::FileTest::FILE_TEST_IS_DIR);
 }
 
 /**
- * Custom fclose method, which is executed during the stream closure of C popen command.
- * Check on fclose return value, signal a failure/pop-up to the user, when exit-code is non-zero.
+ * \brief Execute command on terminal (using /bin/sh). Returns stdout output. Redirect stderr to stdout (2>&1), if you want stderr as well.
+ * \param[in] cmd The command to be executed
+ * \throws runtime_error when the shell could not be started
+ * \return Terminal stdout output
  */
-int Helper::close_exec_stream(std::FILE* file)
+string Helper::exec(const char* cmd)
 {
-  if (file)
-  {
-    if (std::fclose(file) != 0)
-    {
-      // Dispatcher will run the connected slot in the main loop,
-      // instead of the same context/thread in case of a signal.emit() call.
-      // This is needed because the CloseFile is called in a different context then usual!
-      // Signal error message to the user:
-      Helper::get_instance().failure_on_exec.emit();
-    }
-  }
-  return 0; // Just always return OK
+  return ProcessRunner::run({"/bin/sh", "-c", cmd}).output;
 }
 
 /**
@@ -1598,7 +1429,7 @@ string Helper::get_winetricks_version()
   string version = "";
   if (file_exists(WinetricksExecutable))
   {
-    string output = exec((WinetricksExecutable + " --version").c_str());
+    string output = ProcessRunner::run({WinetricksExecutable, "--version"}).output;
     if (!output.empty())
     {
       if (output.length() >= 8)
@@ -1611,48 +1442,338 @@ string Helper::get_winetricks_version()
 }
 
 /**
- * \brief Get a specific value from the Wine registry from disk
- * \param[in] file_path  File path of registry
- * \param[in] key_name   Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
- * \param[in] value_name Specifies the registry value name (eg. Desktop)
+ * \brief Get the parsed registry file from the process-wide cache.
+ * The registry file is only parsed again when the file is changed on disk (inode, size or modification time).
+ * When not in memory yet, the binary snapshot in ~/.winegui/cache is tried first, before parsing the registry text.
+ * \param[in] file_path File path of registry
  * \throws runtime_error when we couldn't load the Windows registry
- * \return Data of value name
+ * \return Parsed registry
  */
-string Helper::get_reg_value(const string& file_path, const string& key_name, const string& value_name)
+std::shared_ptr<const RegistryIndex> Helper::load_registry(const string& file_path)
 {
-  string output;
-  string value_pattern = '"' + value_name + "\"=";
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
+  struct stat file_stat;
+  if (stat(file_path.c_str(), &file_stat) != 0)
   {
-    std::string line;
-    line.reserve(128);
-    bool match = false;
-    while (std::getline(reg_file, line))
+    std::lock_guard<std::mutex> lock(registry_cache_mutex);
+    registry_cache.erase(file_path);
+    throw std::runtime_error("Could not open registry file!");
+  }
+  {
+    std::lock_guard<std::mutex> lock(registry_cache_mutex);
+    auto it = registry_cache.find(file_path);
+    if (it != registry_cache.end())
     {
-      if (!match)
+      const RegistryCacheEntry& entry = it->second;
+      if (entry.device == file_stat.st_dev && entry.inode == file_stat.st_ino && entry.size == file_stat.st_size &&
+          entry.modified.tv_sec == file_stat.st_mtim.tv_sec && entry.modified.tv_nsec == file_stat.st_mtim.tv_nsec)
       {
-        match = line.starts_with(key_name);
+        return entry.registry;
       }
-      else
+    }
+  }
+  // Load outside the lock, so other registry files can be loaded in parallel
+  string snapshot_path = get_registry_snapshot_path(file_path);
+  std::shared_ptr<const RegistryIndex> registry = RegistryIndex::from_snapshot(snapshot_path, file_stat);
+  if (!registry)
+  {
+    // No (valid) snapshot, parse the text and store a new snapshot for the next time
+    registry = std::make_shared<const RegistryIndex>(file_path);
+    save_registry_snapshot(*registry, snapshot_path, file_stat);
+  }
+  std::lock_guard<std::mutex> lock(registry_cache_mutex);
+  registry_cache[file_path] = RegistryCacheEntry{file_stat.st_dev, file_stat.st_ino, file_stat.st_size, file_stat.st_mtim, registry};
+  return registry;
+}
+
+/**
+ * \brief Get current Windows OS version from the registry
+ * \param[in] user_reg Parsed user registry of the bottle (system registry is only loaded when needed)
+ * \param[in] prefix_path Bottle prefix
+ * \throws runtime_error when Windows registry could not be opened or could not determine Windows version
+ * \return Return the Windows OS version
+ */
+BottleTypes::Windows Helper::parse_windows_version(const RegistryIndex& user_reg, const string& prefix_path)
+{
+  // Trying user registry first
+  string win_version = user_reg.get_value(RegKeyWine, RegNameWindowsVersion);
+  if (!win_version.empty())
+  {
+    for (unsigned int i = 0; i < BottleTypes::WindowsEnumSize; i++)
+    {
+      // Check if Windows version matches the win_version string
+      if (((WindowsVersions[i].version).compare(win_version) == 0))
+      {
+        return WindowsVersions[i].windows;
+      }
+    }
+  }
+
+  // Trying system registry, retrieve all the values we might need at once
+  string system_reg_file_path = Glib::build_filename(prefix_path, SystemReg);
+  std::vector<string> system_values = Helper::get_reg_values(
+      system_reg_file_path,
+      {{RegKeyNameNT, RegNameNTVersion}, {RegKeyNameNT, RegNameNTBuildNumber}, {RegKeyType, RegNameProductType}, {RegKeyName9x, RegName9xVersion}});
+  string version = "";
+  if (!(version = system_values.at(0)).empty())
+  {
+    const string& build_number_nt = system_values.at(1);
+    const string& type_nt = system_values.at(2);
+    // Find the correct Windows version, comparing the version, build number and NT type (if present)
+    for (unsigned int i = 0; i < BottleTypes::WindowsEnumSize; i++)
+    {
+      // Check if version + build number matches
+      if (((WindowsVersions[i].versionNumber).compare(version) == 0) && ((WindowsVersions[i].buildNumber).compare(build_number_nt) == 0))
       {
-        std::size_t pos = line.find(value_pattern);
-        if (pos != std::string::npos)
+        if (!type_nt.empty())
+        {
+          if ((WindowsVersions[i].productType).compare(type_nt) == 0)
+          {
+            return WindowsVersions[i].windows;
+          }
+        }
+        else
         {
-          output = line.substr(pos + value_pattern.size());
-          // Remove quotes
-          output.erase(std::remove(output.begin(), output.end(), '\"'), output.end());
-          break;
+          return WindowsVersions[i].windows;
+        }
+      }
+
+      // Fall-back - return the Windows version based on build NT number, even if the version number doesn't exactly match
+      for (unsigned int x = 0; x < BottleTypes::WindowsEnumSize; x++)
+      {
+        // Check if build number matches
+        if ((WindowsVersions[x].buildNumber).compare(build_number_nt) == 0)
+        {
+          if (!type_nt.empty())
+          {
+            if ((WindowsVersions[x].productType).compare(type_nt) == 0)
+            {
+              return WindowsVersions[x].windows;
+            }
+          }
+        }
+      }
+    }
+
+    // Fall-back of fall-back - return the Windows version based on version number, even if the build NT number doesn't exactly match
+    for (unsigned int y = 0; y < BottleTypes::WindowsEnumSize; y++)
+    {
+      // Check if version matches
+      if ((WindowsVersions[y].versionNumber).compare(version) == 0)
+      {
+        if (!type_nt.empty())
+        {
+          if ((WindowsVersions[y].productType).compare(type_nt) == 0)
+          {
+            return WindowsVersions[y].windows;
+          }
+        }
+        else
+        {
+          return WindowsVersions[y].windows;
         }
       }
     }
-    reg_file.close();
+  }
+  else if (!(version = system_values.at(3)).empty())
+  {
+    string current_version = "";
+    string current_build_number = "";
+    std::vector<string> version_list = split(version, '.');
+    // Only get minor & major
+    if (sizeof(version_list) >= 2)
+    {
+      current_version = version_list.at(0) + '.' + version_list.at(1);
+    }
+    // Get build number
+    if (sizeof(version_list) >= 3)
+    {
+      current_build_number = version_list.at(2);
+    }
+
+    // Find Windows version
+    for (unsigned int i = 0; i < BottleTypes::WindowsEnumSize; i++)
+    {
+      // Check if version + build number matches
+      if (((WindowsVersions[i].versionNumber).compare(current_version) == 0) && ((WindowsVersions[i].buildNumber).compare(current_build_number) == 0))
+      {
+        return WindowsVersions[i].windows;
+      }
+    }
+
+    // Fall-back to default Windows version, even if the build number doesn't match
+    return WineDefaults::WindowsOs;
   }
   else
   {
-    throw std::runtime_error("Could not open registry file!");
+    throw std::runtime_error("Could not determine Windows version, we assume " + BottleTypes::to_string(WineDefaults::WindowsOs) +
+                             ". Wine machine: " + get_folder_name(prefix_path) + "\n\nFull location: " + prefix_path);
+  }
+  // Function didn't return before (meaning no match found)
+  throw std::runtime_error("Could not determine Windows version, we assume " + BottleTypes::to_string(WineDefaults::WindowsOs) +
+                           ". Wine machine: " + get_folder_name(prefix_path) + "\n\nFull location: " + prefix_path);
+}
+
+/**
+ * \brief Get system processor bit (32/64) from the registry. *Throw runtime_error* when not found.
+ * \param[in] user_reg Parsed user registry of the bottle
+ * \param[in] prefix_path Bottle prefix
+ * \throws runtime_error when could not determine Windows bitness
+ * \return 32-bit or 64-bit
+ */
+BottleTypes::Bit Helper::parse_windows_bitness(const RegistryIndex& user_reg, const string& prefix_path)
+{
+  string value = user_reg.get_meta_data("arch");
+  if (!value.empty())
+  {
+    if (value.compare("win32") == 0)
+    {
+      return BottleTypes::Bit::win32;
+    }
+    else if (value.compare("win64") == 0)
+    {
+      return BottleTypes::Bit::win64;
+    }
+    else
+    {
+      throw std::runtime_error("Could not determine Windows system bit (not win32 and not win64, value: " + value +
+                               "), for Wine machine: " + get_folder_name(prefix_path) + "\n\nFull location: " + prefix_path);
+    }
+  }
+  else
+  {
+    throw std::runtime_error("Could not determine Windows system bit, for Wine machine: " + get_folder_name(prefix_path) +
+                             "\n\nFull location: " + prefix_path);
   }
-  return output;
+}
+
+/**
+ * \brief Get Audio driver from the registry
+ * \param[in] user_reg Parsed user registry of the bottle
+ * \return Audio Driver (eg. alsa/coreaudio/oss/pulse)
+ */
+BottleTypes::AudioDriver Helper::parse_audio_driver(const RegistryIndex& user_reg)
+{
+  string value = user_reg.get_value(RegKeyAudio, RegNameAudio);
+  if (!value.empty())
+  {
+    if (value.compare("pulse") == 0)
+    {
+      return BottleTypes::AudioDriver::pulseaudio;
+    }
+    else if (value.compare("alsa") == 0)
+    {
+      return BottleTypes::AudioDriver::alsa;
+    }
+    else if (value.compare("oss") == 0)
+    {
+      return BottleTypes::AudioDriver::oss;
+    }
+    else if (value.compare("coreaudio") == 0)
+    {
+      return BottleTypes::AudioDriver::coreaudio;
+    }
+    else if (value.compare("disabled") == 0)
+    {
+      return BottleTypes::AudioDriver::disabled;
+    }
+    else
+    {
+      // Otherwise just return PulseAudio
+      return BottleTypes::AudioDriver::pulseaudio;
+    }
+  }
+  else
+  {
+    // If not found, it is set to PulseAudio
+    return BottleTypes::AudioDriver::pulseaudio;
+  }
+}
+
+/**
+ * \brief Get emulation resolution from the registry
+ * \param[in] user_reg Parsed user registry of the bottle
+ * \return Return the virtual desktop resolution or empty string when disabled fully.
+ */
+string Helper::parse_virtual_desktop(const RegistryIndex& user_reg)
+{
+  // Check if emulate desktop is enabled. Eg. "Desktop"="Default"
+  // The resolution can be found in Key: Software\\Wine\\Explorer\\Desktops with the Value name set as value
+  // (see above, "Default" is the default value). eg. "Default"="1024x768"
+  std::vector<string> values =
+      user_reg.get_values({{RegKeyVirtualDesktop, RegNameVirtualDesktop}, {RegKeyVirtualDesktopResolution, RegNameVirtualDesktopDefault}});
+  const string& emulate_desktop_value = values.at(0);
+  string resolution;
+  if (!emulate_desktop_value.empty())
+  {
+    const string& resolution_value = values.at(1);
+    if (!resolution_value.empty())
+    {
+      resolution = resolution_value;
+    }
+  }
+  return resolution;
+}
+
+/**
+ * \brief Get the snapshot file location of a registry file
+ * \param[in] file_path File path of registry
+ * \return Snapshot file path (unique per registry file path)
+ */
+string Helper::get_registry_snapshot_path(const string& file_path)
+{
+  string file_name = Glib::Checksum::compute_checksum(Glib::Checksum::CHECKSUM_SHA1, file_path) + ".regidx";
+  return Glib::build_filename(RegistryCacheDir, file_name);
+}
+
+/**
+ * \brief Store the binary snapshot of the parsed registry, failures are ignored (the registry text is parsed again next time)
+ * \param[in] registry Parsed registry
+ * \param[in] snapshot_path Snapshot file path
+ * \param[in] source_stat File status of the registry file
+ */
+void Helper::save_registry_snapshot(const RegistryIndex& registry, const string& snapshot_path, const struct stat& source_stat)
+{
+  string snapshot = registry.to_snapshot(source_stat);
+  if (snapshot.empty())
+    return;
+  if (!dir_exists(RegistryCacheDir) && !create_dir(RegistryCacheDir))
+    return;
+  try
+  {
+    // Atomic write, so a parallel load never sees a partial snapshot
+    write_file(snapshot_path, snapshot);
+  }
+  catch (const Glib::FileError&)
+  {
+    // Silently ignore, the snapshot is only an optimization
+  }
+}
+
+/**
+ * \brief Get a specific value from the Wine registry from disk
+ * \param[in] file_path  File path of registry
+ * \param[in] key_name   Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_name Specifies the registry value name (eg. Desktop)
+ * \throws runtime_error when we couldn't load the Windows registry
+ * \return Data of value name
+ */
+string Helper::get_reg_value(const string& file_path, const string& key_name, const string& value_name)
+{
+  auto registry = load_registry(file_path);
+  return registry->get_value(key_name, value_name);
+}
+
+/**
+ * \brief Get multiple values from the Wine registry at once, the registry file is only loaded once
+ * \param[in] file_path       File path of registry
+ * \param[in] key_value_names List of key name + value name pairs (eg. [Software\\\\Wine] + Version)
+ * \throws runtime_error when we couldn't load the Windows registry
+ * \return Data of each value name, in the same order as the input (empty string when not found)
+ */
+std::vector<string> Helper::get_reg_values(const string& file_path, const std::vector<std::pair<string, string>>& key_value_names)
+{
+  auto registry = load_registry(file_path);
+  return registry->get_values(key_value_names);
 }
 
 /**
@@ -1665,31 +1786,11 @@ string Helper::get_reg_value(const string& file_path, const string& key_name, co
 std::vector<string> Helper::get_reg_keys(const string& file_path, const string& key_name)
 {
   std::vector<string> keys;
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
-  {
-    std::string line;
-    line.reserve(128);
-    bool match = false;
-    while (std::getline(reg_file, line))
-    {
-      if (!match)
-      {
-        match = line.starts_with(key_name);
-      }
-      else
-      {
-        if (line.empty() || reg_file.eof())
-          break; // End of key section in registry
-        if (!line.starts_with('#'))
-          keys.push_back(line);
-      }
-    }
-    reg_file.close();
-  }
-  else
+  auto registry = load_registry(file_path);
+  for (std::string_view line : registry->get_key_lines(key_name))
   {
-    throw std::runtime_error("Could not open registry file!");
+    if (!line.starts_with('#'))
+      keys.emplace_back(line);
   }
   return keys;
 }
@@ -1737,42 +1838,24 @@ std::vector<std::pair<string, string>> Helper::get_reg_keys_name_data_pair_filte
                                                                                          const string& key_name_ignore_filter)
 {
   std::vector<std::pair<string, string>> pairs;
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
-  {
-    std::string line;
-    line.reserve(128);
-    bool match = false;
-    while (std::getline(reg_file, line))
+  auto registry = load_registry(file_path);
+  for (std::string_view raw_line : registry->get_key_lines(key_name))
+  {
+    // Skip '#' elements, only unescape the lines that can be returned
+    if (raw_line.starts_with('#'))
+      continue;
+    string line = RegEscape::unescape(raw_line);
+    // If filter is not empty it will only continue if the line contains the filter string
+    if ((key_value_filter.empty() || line.find(key_value_filter) != string::npos) &&
+        (key_name_ignore_filter.empty() || line.find(key_name_ignore_filter) == string::npos))
     {
-      if (!match)
+      line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
+      auto results = split(line, '=');
+      if (results.size() > 1)
       {
-        match = line.starts_with(key_name);
-      }
-      else
-      {
-        if (line.empty() || reg_file.eof())
-          break; // End of key section in registry
-
-        line = unescape_reg_key_data(line);
-        // Skip '#' elements and if filter is not empty it will only continue if the line contains the filter string
-        if (!line.starts_with('#') && (key_value_filter.empty() || line.find(key_value_filter) != string::npos) &&
-            (key_name_ignore_filter.empty() || line.find(key_name_ignore_filter) == string::npos))
-        {
-          line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
-          auto results = split(line, '=');
-          if (results.size() > 1)
-          {
-            pairs.push_back(std::make_pair(results.at(0), results.at(1)));
-          }
-        }
+        pairs.push_back(std::make_pair(results.at(0), results.at(1)));
       }
     }
-    reg_file.close();
-  }
-  else
-  {
-    throw std::runtime_error("Could not open registry file!");
   }
   return pairs;
 }
@@ -1818,43 +1901,25 @@ std::vector<string> Helper::get_reg_keys_value_data_filter_ignore(const string&
                                                                   const string& key_name_ignore_filter)
 {
   std::vector<string> keys;
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
-  {
-    std::string line;
-    line.reserve(128);
-    bool match = false;
-    while (std::getline(reg_file, line))
+  auto registry = load_registry(file_path);
+  for (std::string_view raw_line : registry->get_key_lines(key_name))
+  {
+    // Skip '#' elements, only unescape the lines that can be returned
+    if (raw_line.starts_with('#'))
+      continue;
+    string line = RegEscape::unescape(raw_line);
+    // If filter is not empty it will only continue if the line contains the filter string
+    if ((key_value_filter.empty() || line.find(key_value_filter) != string::npos) &&
+        (key_name_ignore_filter.empty() || line.find(key_name_ignore_filter) == string::npos))
     {
-      if (!match)
+      auto results = split(line, '=');
+      if (results.size() > 1)
       {
-        match = line.starts_with(key_name);
-      }
-      else
-      {
-        if (line.empty() || reg_file.eof())
-          break; // End of key section in registry
-
-        line = unescape_reg_key_data(line);
-        // Skip '#' elements and if filter is not empty it will only continue if the line contains the filter string
-        if (!line.starts_with('#') && (key_value_filter.empty() || line.find(key_value_filter) != string::npos) &&
-            (key_name_ignore_filter.empty() || line.find(key_name_ignore_filter) == string::npos))
-        {
-          auto results = split(line, '=');
-          if (results.size() > 1)
-          {
-            line = results.at(1);
-            line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
-            keys.push_back(line);
-          }
-        }
+        line = results.at(1);
+        line.erase(std::remove(line.begin(), line.end(), '\"'), line.end());
+        keys.push_back(line);
       }
     }
-    reg_file.close();
-  }
-  else
-  {
-    throw std::runtime_error("Could not open registry file!");
   }
   return keys;
 }
@@ -1868,31 +1933,244 @@ std::vector<string> Helper::get_reg_keys_value_data_filter_ignore(const string&
  */
 string Helper::get_reg_meta_data(const string& file_path, const string& meta_value_name)
 {
-  string output;
-  string meta_pattern = "#" + meta_value_name + "=";
-  std::ifstream reg_file(file_path);
-  if (reg_file.is_open())
+  auto registry = load_registry(file_path);
+  return registry->get_meta_data(meta_value_name);
+}
+
+/**
+ * \brief Check if the wineserver of the bottle is running, by checking the lock of the wineserver.
+ * A running wineserver holds the registry in memory, and will overwrite the registry files on disk.
+ * \param[in] prefix_path Bottle prefix
+ * \return true if the wineserver is running, otherwise false
+ */
+bool Helper::is_wineserver_running(const string& prefix_path)
+{
+  struct stat prefix_stat;
+  if (stat(prefix_path.c_str(), &prefix_stat) != 0)
+    return false;
+  // Same server directory as Wine: /tmp/.wine-<uid>/server-<device>-<inode>
+  std::ostringstream server_dir;
+  server_dir << "/tmp/.wine-" << getuid() << "/server-" << std::hex << static_cast<unsigned long long>(prefix_stat.st_dev) << "-"
+             << static_cast<unsigned long long>(prefix_stat.st_ino);
+  string lock_path = Glib::build_filename(server_dir.str(), "lock");
+  int fd = open(lock_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+    return false;
+  struct flock lock = {};
+  lock.l_type = F_WRLCK;
+  lock.l_whence = SEEK_SET;
+  lock.l_start = 0;
+  lock.l_len = 1;
+  bool is_running = (fcntl(fd, F_GETLK, &lock) == 0 && lock.l_type != F_UNLCK);
+  close(fd);
+  return is_running;
+}
+
+/**
+ * \brief Set a value in the Wine registry. Written directly to disk when the wineserver is not running,
+ * otherwise the change is done via the running wineserver (using wine reg).
+ * A wineserver that is started during the write could have loaded the previous registry file, and would overwrite the change when it exits.
+ * So the wineserver is checked again after the write, and when it is running now the change is done via the wineserver as well.
+ * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary (only used when wineserver is running)
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] reg_file    Registry file name (user.reg or system.reg)
+ * \param[in] key_name    Full path of the key, starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_name  Registry value name (eg. Desktop)
+ * \param[in] data        New data of the value (string)
+ * \throws runtime_error when the registry could not be changed
+ */
+void Helper::set_reg_value(
+    bool wine_64_bit, const string& prefix_path, const string& reg_file, const string& key_name, const string& value_name, const string& data)
+{
+  if (!is_wineserver_running(prefix_path))
   {
-    std::string line;
-    line.reserve(80);
-    while (std::getline(reg_file, line))
+    update_reg_file(Glib::build_filename(prefix_path, reg_file), key_name, value_name, &data);
+    if (!is_wineserver_running(prefix_path))
+      return;
+  }
+  ProcessOptions options;
+  options.environment.push_back("WINEPREFIX=" + prefix_path);
+  options.discard_output = true;
+  string wine = get_wine_executable_location(wine_64_bit);
+  if (ProcessRunner::run({wine, "reg", "add", get_reg_key_path(reg_file, key_name), "/v", value_name, "/d", data, "/f"}, options).exit_code != 0)
+  {
+    throw std::runtime_error("Could not change registry value " + value_name + " (via running wineserver)");
+  }
+}
+
+/**
+ * \brief Delete a value from the Wine registry (if present). Written directly to disk when the wineserver is not running,
+ * otherwise the change is done via the running wineserver (using wine reg).
+ * Like set_reg_value(), the value is deleted via the wineserver as well when the wineserver is started during the write.
+ * \param[in] wine_64_bit If true use Wine 64-bit binary, false use 32-bit binary (only used when wineserver is running)
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] reg_file    Registry file name (user.reg or system.reg)
+ * \param[in] key_name    Full path of the key, starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_name  Registry value name (eg. Desktop)
+ * \throws runtime_error when the registry could not be changed
+ */
+void Helper::delete_reg_value(bool wine_64_bit, const string& prefix_path, const string& reg_file, const string& key_name, const string& value_name)
+{
+  if (!is_wineserver_running(prefix_path))
+  {
+    update_reg_file(Glib::build_filename(prefix_path, reg_file), key_name, value_name, nullptr);
+    if (!is_wineserver_running(prefix_path))
+      return;
+  }
+  // Exit code is ignored, wine reg also fails when the value is not present
+  ProcessOptions options;
+  options.environment.push_back("WINEPREFIX=" + prefix_path);
+  options.discard_output = true;
+  string wine = get_wine_executable_location(wine_64_bit);
+  ProcessRunner::run({wine, "reg", "delete", get_reg_key_path(reg_file, key_name), "/v", value_name, "/f"}, options);
+}
+
+/**
+ * \brief Change or remove a value in the registry file on disk (only allowed when the wineserver is not running).
+ * The key is created when missing. The file is only written when changed, and written atomically.
+ * \param[in] file_path  File path of registry
+ * \param[in] key_name   Full path of the key, starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_name Registry value name (eg. Desktop)
+ * \param[in] data       New data of the value (string), or nullptr to remove the value
+ * \throws runtime_error when the registry file could not be read or written
+ */
+void Helper::update_reg_file(const string& file_path, const string& key_name, const string& value_name, const string* data)
+{
+  string contents;
+  try
+  {
+    contents = read_file(file_path);
+  }
+  catch (const Glib::FileError& error)
+  {
+    throw std::runtime_error("Could not open registry file!\n" + string(error.what()));
+  }
+
+  string value_prefix = "\"" + escape_reg_string(value_name) + "\"=";
+  string value_line = (data != nullptr) ? value_prefix + "\"" + escape_reg_string(*data) + "\"" : "";
+  bool is_value_found = false;
+  bool is_changed = false;
+
+  // Search the key section header, eg. [Software\\\\Wine] 1680000000
+  std::size_t header = contents.find("\n" + key_name + " ");
+  if (header != string::npos)
+  {
+    std::size_t section_start = contents.find('\n', header + 1);
+    section_start = (section_start != string::npos) ? section_start + 1 : contents.size();
+    // Key section ends at the first empty line
+    std::size_t section_end = contents.find("\n\n", section_start - 1);
+    section_end = (section_end != string::npos) ? section_end + 1 : contents.size();
+
+    std::size_t line_start = section_start;
+    while (line_start < section_end)
     {
-      std::size_t pos = line.find(meta_pattern);
-      if (pos != std::string::npos)
+      std::size_t line_end = std::min(contents.find('\n', line_start), section_end);
+      if (contents.compare(line_start, value_prefix.size(), value_prefix) == 0)
       {
-        output = line.substr(pos + meta_pattern.size());
-        // Remove quotes
-        output.erase(std::remove(output.begin(), output.end(), '\"'), output.end());
+        is_value_found = true;
+        if (data == nullptr)
+        {
+          // Remove the whole line, including the new line
+          contents.erase(line_start, std::min(line_end + 1, contents.size()) - line_start);
+          is_changed = true;
+        }
+        else if (contents.compare(line_start, line_end - line_start, value_line) != 0)
+        {
+          contents.replace(line_start, line_end - line_start, value_line);
+          is_changed = true;
+        }
         break;
       }
+      line_start = line_end + 1;
+    }
+    if (!is_value_found && data != nullptr)
+    {
+      // Add the value at the end of the key section
+      contents.insert(section_end, (contents[section_end - 1] != '\n') ? "\n" + value_line : value_line + "\n");
+      is_changed = true;
     }
-    reg_file.close();
   }
-  else
+  else if (data != nullptr)
   {
-    throw std::runtime_error("Could not open registry file!");
+    // Add a new key section at the end, including the modification time (Unix time and Windows FILETIME)
+    std::time_t now = std::time(nullptr);
+    unsigned long long file_time = (static_cast<unsigned long long>(now) + 11644473600ULL) * 10000000ULL;
+    std::ostringstream section;
+    section << "\n" << key_name << " " << now << "\n#time=" << std::hex << file_time << "\n" << value_line << "\n";
+    if (!contents.empty() && contents.back() != '\n')
+      contents += '\n';
+    contents += section.str();
+    is_changed = true;
+  }
+
+  if (is_changed)
+  {
+    try
+    {
+      write_file(file_path, contents);
+    }
+    catch (const Glib::FileError& error)
+    {
+      throw std::runtime_error("Could not write registry file!\n" + string(error.what()));
+    }
   }
-  return output;
+}
+
+/**
+ * \brief Get the full registry key path as used by wine reg (eg. HKEY_CURRENT_USER\\Software\\Wine)
+ * \param[in] reg_file Registry file name (user.reg or system.reg)
+ * \param[in] key_name Key name as written in the registry file (eg. [Software\\\\Wine])
+ * \return Registry key path
+ */
+string Helper::get_reg_key_path(const string& reg_file, const string& key_name)
+{
+  string root_key = (reg_file == SystemReg) ? "HKEY_LOCAL_MACHINE\\" : "HKEY_CURRENT_USER\\";
+  // Remove the brackets and the escaping of the backslashes
+  return root_key + RegEscape::unescape(std::string_view(key_name).substr(1, key_name.size() - 2));
+}
+
+/**
+ * \brief Escape a string for the Wine registry file, the opposite of RegEscape::unescape()
+ * \param[in] src UTF-8 string
+ * \return Escaped string (without surrounding quotes)
+ */
+string Helper::escape_reg_string(const string& src)
+{
+  string dest;
+  dest.reserve(src.size());
+  auto write_hex = [&dest](unsigned int value) {
+    std::array<char, 8> hex;
+    // Always 4 hex digits, so a next character is never mistaken as part of the escape
+    std::snprintf(hex.data(), hex.size(), "\\x%04x", value);
+    dest += hex.data();
+  };
+  for (gunichar ch : Glib::ustring(src))
+  {
+    if (ch == '\\' || ch == '"')
+    {
+      dest += '\\';
+      dest += static_cast<char>(ch);
+    }
+    else if (ch == '\n')
+    {
+      dest += "\\n";
+    }
+    else if (ch >= 32 && ch <= 127)
+    {
+      dest += static_cast<char>(ch);
+    }
+    else if (ch > 0xffff)
+    {
+      // Wine stores UTF-16, so use a surrogate pair
+      write_hex(0xd800 + ((ch - 0x10000) >> 10));
+      write_hex(0xdc00 + ((ch - 0x10000) & 0x3ff));
+    }
+    else
+    {
+      write_hex(ch);
+    }
+  }
+  return dest;
 }
 
 /**
@@ -1984,154 +2262,6 @@ bool Helper::case_insensitive_compare(const std::string& a, const std::string& b
   return std::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end(), case_insensitive_less());
 }
 
-/**
- * \brief Parse an escaped Wine registry key data back into an UTF-8 string
- * The code is adopted from the parse_strW() method:
- * https://source.winehq.org/git/wine.git/blob/refs/heads/master:/server/unicode.c#l101
- *
- * \param[in] src Key data to be unescaped
- * \return UTF-8 string
- */
-string Helper::unescape_reg_key_data(const string& src)
-{
-  auto to_hex = [](char ch) -> char { return std::isdigit(ch) ? ch - '0' : std::tolower(ch) - 'a' + 10; };
-
-  auto wchar_to_utf8 = [](wchar_t wc) -> string {
-    string s;
-    if (0 <= wc && wc <= 0x7f)
-    {
-      s += (char)wc;
-    }
-    else if (0x80 <= wc && wc <= 0x7ff)
-    {
-      s += (0xc0 | (wc >> 6));
-      s += (0x80 | (wc & 0x3f));
-    }
-    else if (0x800 <= wc && wc <= 0xffff)
-    {
-      s += (0xe0 | (wc >> 12));
-      s += (0x80 | ((wc >> 6) & 0x3f));
-      s += (0x80 | (wc & 0x3f));
-    }
-    else if (0x10000 <= wc && wc <= 0x1fffff)
-    {
-      s += (0xf0 | (wc >> 18));
-      s += (0x80 | ((wc >> 12) & 0x3f));
-      s += (0x80 | ((wc >> 6) & 0x3f));
-      s += (0x80 | (wc & 0x3f));
-    }
-    else if (0x200000 <= wc && wc <= 0x3ffffff)
-    {
-      s += (0xf8 | (wc >> 24));
-      s += (0x80 | ((wc >> 18) & 0x3f));
-      s += (0x80 | ((wc >> 12) & 0x3f));
-      s += (0x80 | ((wc >> 6) & 0x3f));
-      s += (0x80 | (wc & 0x3f));
-    }
-    else if (0x4000000 <= wc && wc <= 0x7fffffff)
-    {
-      s += (0xfc | (wc >> 30));
-      s += (0x80 | ((wc >> 24) & 0x3f));
-      s += (0x80 | ((wc >> 18) & 0x3f));
-      s += (0x80 | ((wc >> 12) & 0x3f));
-      s += (0x80 | ((wc >> 6) & 0x3f));
-      s += (0x80 | (wc & 0x3f));
-    }
-    return s;
-  };
-
-  string dest;
-  dest.reserve(src.length());
-
-  const char* p = src.c_str();
-  while (*p)
-  {
-    if (*p == '\\')
-    {
-      p++;
-      if (!*p)
-        break;
-
-      switch (*p)
-      {
-      case 'a':
-        dest += '\a';
-        p++;
-        continue;
-      case 'b':
-        dest += '\b';
-        p++;
-        continue;
-      case 'e':
-        dest += '\e';
-        p++;
-        continue;
-      case 'f':
-        dest += '\f';
-        p++;
-        continue;
-      case 'n':
-        dest += '\n';
-        p++;
-        continue;
-      case 'r':
-        dest += '\r';
-        p++;
-        continue;
-      case 't':
-        dest += '\t';
-        p++;
-        continue;
-      case 'v':
-        dest += '\v';
-        p++;
-        continue;
-
-      // hex escape
-      case 'x':
-        p++;
-        if (!std::isxdigit(*p))
-          dest += 'x';
-        else
-        {
-          wchar_t wch = to_hex(*p++);
-          if (std::isxdigit(*p))
-            wch = (wch * 16) + to_hex(*p++);
-          if (std::isxdigit(*p))
-            wch = (wch * 16) + to_hex(*p++);
-          if (std::isxdigit(*p))
-            wch = (wch * 16) + to_hex(*p++);
-          dest += wchar_to_utf8(wch);
-        }
-        continue;
-
-      // octal escape
-      case '0':
-      case '1':
-      case '2':
-      case '3':
-      case '4':
-      case '5':
-      case '6':
-      case '7':
-      {
-        wchar_t wch = *p++ - '0';
-        if (*p >= '0' && *p <= '7')
-          wch = (wch * 8) + (*p++ - '0');
-        if (*p >= '0' && *p <= '7')
-          wch = (wch * 8) + (*p++ - '0');
-        dest += wchar_to_utf8(wch);
-        continue;
-      }
-      }
-      // unrecognized escape: fall through to normal char handling
-    }
-
-    dest += *p++;
-  }
-  return dest;
-}
-
 /**
  * Convert string (chars) to hex
  * \param[in] str Source string
@@ -0,0 +1,273 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    job_scheduler.cc
+ * \brief   Runs the bottle actions, with a job list
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "job_scheduler.h"
+#include <glibmm/error.h>
+#include <algorithm>
+#include <deque>
+#include <iostream>
+#include <map>
+#include <mutex>
+#include <thread>
+#include <utility>
+
+static const std::size_t MaxFinishedJobs = 50; /*!< Older finished jobs are removed from the job list */
+
+/**
+ * \brief Job list entry
+ */
+struct JobRecord
+{
+  JobInfo info;
+  std::chrono::steady_clock::time_point steady_start_time; /*!< Used for the duration */
+};
+
+/**
+ * \brief The job list and the queued exclusive jobs
+ */
+struct JobScheduler::JobList
+{
+  std::mutex mutex;                      /*!< Protects all the members */
+  std::deque<JobRecord> records;         /*!< Job list, by job number */
+  std::function<void()> on_jobs_changed; /*!< Called when the job list is changed */
+  std::size_t next_id = 1;
+  bool is_stopping = false;
+  /// Bottles with a running exclusive job, with their queued exclusive jobs
+  std::map<std::string, std::deque<std::pair<std::size_t, std::function<void()>>>> busy_bottles;
+
+  /**
+   * \brief Add a queued job to the job list (must hold the mutex)
+   */
+  std::size_t add(const std::string& prefix_path, const std::string& description, bool is_exclusive)
+  {
+    std::size_t id = next_id++;
+    records.push_back({{id, prefix_path, description, is_exclusive, JobState::Queued, {}, {}}, {}});
+    return id;
+  }
+
+  /**
+   * \brief Find a job by its job number (must hold the mutex)
+   */
+  JobRecord* find(std::size_t id)
+  {
+    auto it = std::lower_bound(records.begin(), records.end(), id, [](const JobRecord& record, std::size_t value) { return record.info.id < value; });
+    return (it != records.end() && it->info.id == id) ? &*it : nullptr;
+  }
+
+  /**
+   * \brief Remove the oldest finished jobs from the job list (must hold the mutex)
+   */
+  void remove_old_jobs()
+  {
+    auto is_done = [](const JobRecord& record) { return record.info.state == JobState::Finished || record.info.state == JobState::Failed; };
+    std::size_t done_count = std::count_if(records.begin(), records.end(), is_done);
+    for (auto it = records.begin(); done_count > MaxFinishedJobs && it != records.end();)
+    {
+      if (is_done(*it))
+      {
+        it = records.erase(it);
+        --done_count;
+      }
+      else
+      {
+        ++it;
+      }
+    }
+  }
+
+  /**
+   * \brief Inform about the changed job list (must hold the mutex)
+   */
+  void changed()
+  {
+    if (on_jobs_changed)
+      on_jobs_changed();
+  }
+
+  /**
+   * \brief Run a job, the job list is updated before and after
+   */
+  void run(std::size_t id, const std::function<void()>& job)
+  {
+    {
+      std::lock_guard<std::mutex> lock(mutex);
+      if (JobRecord* record = find(id))
+      {
+        record->info.state = JobState::Running;
+        record->info.start_time = std::chrono::system_clock::now();
+        record->steady_start_time = std::chrono::steady_clock::now();
+      }
+      changed();
+    }
+    JobState state = JobState::Finished;
+    try
+    {
+      job();
+    }
+    catch (const std::exception& error)
+    {
+      std::cout << "Error: Unhandled exception in job: " << error.what() << std::endl;
+      state = JobState::Failed;
+    }
+    catch (const Glib::Error& error)
+    {
+      std::cout << "Error: Unhandled exception in job: " << error.what() << std::endl;
+      state = JobState::Failed;
+    }
+    catch (...)
+    {
+      std::cout << "Error: Unknown exception in job" << std::endl;
+      state = JobState::Failed;
+    }
+    std::lock_guard<std::mutex> lock(mutex);
+    if (JobRecord* record = find(id))
+    {
+      record->info.state = state;
+      record->info.duration = std::chrono::steady_clock::now() - record->steady_start_time;
+    }
+    remove_old_jobs();
+    changed();
+  }
+};
+
+/**
+ * \brief Start the worker threads for the exclusive jobs
+ * \param[in] thread_count Number of worker threads (the maximum number of bottles changed at the same time)
+ * \param[in] on_jobs_changed Called when the job list is changed (from any thread)
+ */
+JobScheduler::JobScheduler(unsigned int thread_count, std::function<void()> on_jobs_changed)
+    : jobs_(std::make_shared<JobList>()), pool_(thread_count)
+{
+  jobs_->on_jobs_changed = std::move(on_jobs_changed);
+}
+
+/**
+ * \brief Queued jobs are not started anymore, waits for the running exclusive jobs. Launched programs keep running.
+ */
+JobScheduler::~JobScheduler()
+{
+  {
+    std::lock_guard<std::mutex> lock(jobs_->mutex);
+    jobs_->is_stopping = true;
+    jobs_->on_jobs_changed = nullptr;
+  }
+  pool_.cancel_pending();
+}
+
+/**
+ * \brief Launch a program in its own thread, starts immediately (eg. a Windows application)
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] description Short description for the job list
+ * \param[in] job Job function, returns when the program is closed
+ * \return Job number
+ */
+std::size_t JobScheduler::launch(const std::string& prefix_path, const std::string& description, std::function<void()> job)
+{
+  std::size_t id;
+  {
+    std::lock_guard<std::mutex> lock(jobs_->mutex);
+    id = jobs_->add(prefix_path, description, false);
+    jobs_->changed();
+  }
+  // Not joined, WineGUI doesn't wait for the programs on exit (the thread keeps the job list alive)
+  std::thread([jobs = jobs_, id, job = std::move(job)] { jobs->run(id, job); }).detach();
+  return id;
+}
+
+/**
+ * \brief Post an exclusive job, it runs after the previous exclusive jobs of the same bottle are finished (eg. an install)
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] description Short description for the job list
+ * \param[in] job Job function
+ * \return Job number
+ */
+std::size_t JobScheduler::post(const std::string& prefix_path, const std::string& description, std::function<void()> job)
+{
+  std::size_t id;
+  {
+    std::lock_guard<std::mutex> lock(jobs_->mutex);
+    id = jobs_->add(prefix_path, description, true);
+    jobs_->changed();
+    auto bottle = jobs_->busy_bottles.find(prefix_path);
+    if (bottle != jobs_->busy_bottles.end())
+    {
+      // Started when the running job of this bottle is finished
+      bottle->second.emplace_back(id, std::move(job));
+      return id;
+    }
+    jobs_->busy_bottles[prefix_path];
+    // Posted while holding the mutex, so it can't be posted after the destructor cancelled the pending jobs
+    pool_.post([this, id, prefix_path, job = std::move(job)]() mutable { run_exclusive(id, prefix_path, std::move(job)); });
+  }
+  return id;
+}
+
+/**
+ * \brief Check if exclusive jobs of the bottle are running or queued
+ * \param[in] prefix_path Bottle prefix
+ * \return true when a job of the bottle is not finished yet
+ */
+bool JobScheduler::is_busy(const std::string& prefix_path) const
+{
+  std::lock_guard<std::mutex> lock(jobs_->mutex);
+  return jobs_->busy_bottles.contains(prefix_path);
+}
+
+/**
+ * \brief Get the job list, by job number
+ * \return Copy of the job list
+ */
+std::vector<JobInfo> JobScheduler::get_jobs() const
+{
+  std::lock_guard<std::mutex> lock(jobs_->mutex);
+  auto now = std::chrono::steady_clock::now();
+  std::vector<JobInfo> jobs;
+  jobs.reserve(jobs_->records.size());
+  for (const JobRecord& record : jobs_->records)
+  {
+    jobs.push_back(record.info);
+    if (record.info.state == JobState::Running)
+      jobs.back().duration = now - record.steady_start_time;
+  }
+  return jobs;
+}
+
+/**
+ * \brief Run an exclusive job and post the next queued job of the same bottle (runs in worker thread)
+ * \param[in] id Job number
+ * \param[in] prefix_path Bottle prefix
+ * \param[in] job Job function
+ */
+void JobScheduler::run_exclusive(std::size_t id, const std::string& prefix_path, std::function<void()> job)
+{
+  jobs_->run(id, job);
+
+  std::lock_guard<std::mutex> lock(jobs_->mutex);
+  auto bottle = jobs_->busy_bottles.find(prefix_path);
+  if (jobs_->is_stopping || bottle->second.empty())
+  {
+    jobs_->busy_bottles.erase(bottle);
+    return;
+  }
+  auto [next_id, next_job] = std::move(bottle->second.front());
+  bottle->second.pop_front();
+  // Posted while holding the mutex, the destructor sets is_stopping before it cancels the pending jobs
+  pool_.post([this, next_id, prefix_path, next_job = std::move(next_job)]() mutable { run_exclusive(next_id, prefix_path, std::move(next_job)); });
+}
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    log_sink.cc
+ * \brief   Stream program output to a log file
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "log_sink.h"
+#include "log_writer.h"
+#include <utility>
+
+static const std::size_t BufferSize = 64 * 1024; /*!< Output is passed to the log writer in chunks of 64 KiB */
+
+/**
+ * \brief Log sink of a single program run
+ * \param[in] file_path Log file path, output is appended
+ * \param[in] is_enabled Set to false to discard the output (eg. when debug logging is disabled)
+ */
+LogSink::LogSink(const std::string& file_path, bool is_enabled)
+    : file_path_(file_path), is_enabled_(is_enabled), last_char_('\n'), last_flush_(std::chrono::steady_clock::now())
+{
+  if (is_enabled_)
+    buffer_.reserve(BufferSize);
+}
+
+/**
+ * \brief Pass the remaining output to the log writer. The log always ends with a new line.
+ */
+LogSink::~LogSink()
+{
+  if (last_char_ != '\n')
+    buffer_.push_back('\n');
+  flush();
+}
+
+/**
+ * \brief Add output of the program, passed to the log writer when the buffer is full or the flush interval is passed
+ * \param[in] output Program output
+ */
+void LogSink::write(std::string_view output)
+{
+  if (!is_enabled_ || output.empty())
+    return;
+  buffer_.append(output);
+  last_char_ = output.back();
+  if (buffer_.size() >= BufferSize || std::chrono::steady_clock::now() - last_flush_ >= FlushInterval)
+    flush();
+}
+
+/**
+ * \brief Pass the buffered output to the log writer, which appends it to the log file
+ */
+void LogSink::flush()
+{
+  if (!buffer_.empty())
+  {
+    LogWriter::write(file_path_, std::move(buffer_));
+    buffer_.clear();
+    buffer_.reserve(BufferSize);
+  }
+  last_flush_ = std::chrono::steady_clock::now();
+}
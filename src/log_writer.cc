@@ -0,0 +1,219 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    log_writer.cc
+ * \brief   Single writer of the log records of all the running programs
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "log_writer.h"
+#include <algorithm>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <map>
+#include <sys/uio.h>
+#include <unistd.h>
+#include <vector>
+
+static const std::size_t MaxBytesInFlight = 16 * 1024 * 1024; /*!< Producers wait when this much log data isn't written yet */
+
+/**
+ * \brief Append all the data to the file, with as few system calls as possible
+ * \param[in] fd File descriptor
+ * \param[in] iov Data to write (is modified)
+ * \return True when everything is written, false on error (errno is set)
+ */
+static bool write_all(int fd, std::vector<struct iovec>& iov)
+{
+  std::size_t index = 0;
+  while (index < iov.size())
+  {
+    int count = static_cast<int>(std::min<std::size_t>(iov.size() - index, IOV_MAX));
+    ssize_t written = writev(fd, &iov[index], count);
+    if (written < 0)
+    {
+      if (errno == EINTR)
+        continue;
+      return false;
+    }
+    // Skip the written data, the last buffer can be written partially
+    std::size_t remaining = static_cast<std::size_t>(written);
+    while (index < iov.size() && remaining >= iov[index].iov_len)
+    {
+      remaining -= iov[index].iov_len;
+      ++index;
+    }
+    if (remaining > 0)
+    {
+      iov[index].iov_base = static_cast<char*>(iov[index].iov_base) + remaining;
+      iov[index].iov_len -= remaining;
+    }
+  }
+  return true;
+}
+
+/**
+ * \brief Append data to a log file, the log file is created when it doesn't exist
+ * \param[in] file_path Log file path
+ * \param[in] iov Data to append (is modified)
+ */
+static void append_to_file(const std::string& file_path, std::vector<struct iovec>& iov)
+{
+  int fd = open(file_path.c_str(), O_WRONLY | O_APPEND | O_CREAT | O_CLOEXEC, 0644);
+  if (fd < 0 || !write_all(fd, iov))
+  {
+    std::cout << "Error: Couldn't write debug logging to log file. Error " << std::strerror(errno) << std::endl;
+  }
+  if (fd >= 0)
+    close(fd);
+}
+
+/// Singleton, the queued records are written at exit
+LogWriter::LogWriter()
+    : queue_head_(nullptr), bytes_in_flight_(0), is_exiting_(false), active_producers_(0), writer_thread_(&LogWriter::writer_loop, this)
+{
+  std::atexit(&LogWriter::flush_at_exit);
+}
+/// Destructor (never called)
+LogWriter::~LogWriter() = default;
+
+/**
+ * \brief Get singleton instance
+ * \return LogWriter reference (singleton)
+ */
+LogWriter& LogWriter::get_instance()
+{
+  // Intentionally leaked: detached threads can still write logging during and after the static destruction
+  static LogWriter* instance = new LogWriter();
+  return *instance;
+}
+
+/**
+ * \brief Wait until the queued records are written (registered with atexit), later data is written directly by the producers
+ */
+void LogWriter::flush_at_exit()
+{
+  LogWriter& writer = get_instance();
+  // Sequentially consistent with the producers: either a producer sees is_exiting_, or it is counted in active_producers_ here
+  writer.is_exiting_.store(true);
+  std::size_t active_producers = writer.active_producers_.load();
+  while (active_producers != 0)
+  {
+    writer.active_producers_.wait(active_producers);
+    active_producers = writer.active_producers_.load();
+  }
+  // All the records are pushed now, wait until they are written
+  std::size_t bytes_in_flight = writer.bytes_in_flight_.load(std::memory_order_acquire);
+  while (bytes_in_flight != 0)
+  {
+    writer.bytes_in_flight_.wait(bytes_in_flight, std::memory_order_acquire);
+    bytes_in_flight = writer.bytes_in_flight_.load(std::memory_order_acquire);
+  }
+}
+
+/**
+ * \brief Append data to a log file (the data is written by the writer thread).
+ * Can be called from multiple threads at the same time, without waiting on each other. Blocks while the writer is behind
+ * on the disk by more than 16 MiB (a soft limit, each producer can add one more chunk).
+ * \param[in] file_path Log file path
+ * \param[in] data Data to append
+ */
+void LogWriter::write(const std::string& file_path, std::string data)
+{
+  if (file_path.empty() || data.empty())
+    return;
+  LogWriter& writer = get_instance();
+  std::size_t bytes_in_flight = writer.bytes_in_flight_.load(std::memory_order_acquire);
+  while (bytes_in_flight >= MaxBytesInFlight)
+  {
+    writer.bytes_in_flight_.wait(bytes_in_flight, std::memory_order_acquire);
+    bytes_in_flight = writer.bytes_in_flight_.load(std::memory_order_acquire);
+  }
+  // The exit check and the push are done as one step for flush_at_exit(), which waits for the active producers
+  writer.active_producers_.fetch_add(1);
+  if (writer.is_exiting_.load())
+  {
+    writer.leave_producer();
+    // The writer thread isn't waited for anymore
+    std::vector<struct iovec> iov{{data.data(), data.size()}};
+    append_to_file(file_path, iov);
+    return;
+  }
+  writer.bytes_in_flight_.fetch_add(data.size(), std::memory_order_relaxed);
+  writer.push(new LogRecord{file_path, std::move(data), nullptr});
+  writer.leave_producer();
+}
+
+/**
+ * \brief Leave the exit check and push of a producer, flush_at_exit() is woken up by the last producer
+ */
+void LogWriter::leave_producer()
+{
+  if (active_producers_.fetch_sub(1) == 1)
+    active_producers_.notify_all();
+}
+
+/**
+ * \brief Push a record on the queue, the writer thread is woken up when the queue was empty
+ * \param[in] record Log record (ownership is passed to the queue)
+ */
+void LogWriter::push(LogRecord* record)
+{
+  LogRecord* head = queue_head_.load(std::memory_order_relaxed);
+  do
+  {
+    record->next = head;
+  } while (!queue_head_.compare_exchange_weak(head, record, std::memory_order_release, std::memory_order_relaxed));
+  if (head == nullptr)
+    queue_head_.notify_one();
+}
+
+/**
+ * \brief Take all the queued records at once and write them, one open and write per log file for each batch
+ */
+void LogWriter::writer_loop()
+{
+  while (true)
+  {
+    queue_head_.wait(nullptr, std::memory_order_acquire);
+    LogRecord* head = queue_head_.exchange(nullptr, std::memory_order_acquire);
+
+    // The queue is last-in first-out, reverse it to get the records in the order they were written
+    std::vector<LogRecord*> batch;
+    for (LogRecord* record = head; record != nullptr; record = record->next)
+      batch.push_back(record);
+    std::reverse(batch.begin(), batch.end());
+
+    std::map<std::string, std::vector<struct iovec>> data_by_file;
+    std::size_t batch_size = 0;
+    for (LogRecord* record : batch)
+    {
+      data_by_file[record->file_path].push_back({record->data.data(), record->data.size()});
+      batch_size += record->data.size();
+    }
+    for (auto& [file_path, iov] : data_by_file)
+      append_to_file(file_path, iov);
+    for (LogRecord* record : batch)
+      delete record;
+
+    // Wake up the producers waiting for the writer
+    bytes_in_flight_.fetch_sub(batch_size, std::memory_order_release);
+    bytes_in_flight_.notify_all();
+  }
+}
@@ -62,7 +62,10 @@ MainWindow::MainWindow(Menu& menu)
   // Add menu to box (top), no expand/fill
   vbox.pack_start(menu, false, false);
 
-  // Add paned to box (below menu)
+  // Add status bar to the bottom of the box, no expand/fill
+  vbox.pack_end(statusbar, false, false);
+
+  // Add paned to box (below menu, above status bar)
   // NOTE: expand/fill = true
   vbox.pack_end(paned);
 
@@ -82,10 +85,10 @@ MainWindow::MainWindow(Menu& menu)
   // By default disable the toolbar buttons
   set_sensitive_toolbar_buttons(false);
 
-  // Left side (listbox)
-  listbox.signal_row_selected().connect(sigc::mem_fun(*this, &MainWindow::on_bottle_row_clicked));
+  // Left side (bottle list)
+  bottle_list_treeview.get_selection()->signal_changed().connect(sigc::mem_fun(*this, &MainWindow::on_bottle_row_clicked));
   // Disabled right-click menu for now, since it doesn't activate the right-clicked bottle as active
-  // listbox.signal_button_press_event().connect(right_click_menu);
+  // bottle_list_treeview.signal_button_press_event().connect(right_click_menu);
 
   // Right panel toolbar menu buttons
   // New button pressed signal
@@ -134,25 +137,46 @@ MainWindow::~MainWindow()
 }
 
 /**
- * \brief Set a list of bottles to the left panel
+ * \brief Set a list of bottles to the left panel, only the rows of the added and removed bottles are changed
  * \param[in] bottles - Wine Bottle item list
  */
 void MainWindow::set_wine_bottles(std::list<BottleItem>& bottles)
 {
-  // Clear whole listbox
-  std::vector<Gtk::Widget*> children = listbox.get_children();
-  for (Gtk::Widget* el : children)
+  // Remove the rows that are no longer in the list
+  std::set<const BottleItem*> current_bottles;
+  for (const BottleItem& bottle : bottles)
   {
-    listbox.remove(*el);
+    current_bottles.insert(&bottle);
   }
-
+  std::erase_if(bottle_list_rows, [this, &current_bottles](const auto& row) {
+    bool is_removed = !current_bottles.contains(row.first);
+    if (is_removed)
+      bottle_list_store->erase(row.second);
+    return is_removed;
+  });
+
+  // Insert the new rows, the existing rows are already in the same order
+  Gtk::TreeModel::iterator next_row = bottle_list_store->children().begin();
   for (BottleItem& bottle : bottles)
   {
-    listbox.add(bottle);
+    auto existing_row = bottle_list_rows.find(&bottle);
+    if (existing_row != bottle_list_rows.end())
+    {
+      next_row = existing_row->second;
+      ++next_row;
+    }
+    else
+    {
+      Gtk::TreeModel::iterator row = bottle_list_store->insert(next_row);
+      (*row)[bottle_list_columns.bottle] = &bottle;
+      bottle_list_rows.emplace(&bottle, row);
+    }
   }
   // Enable/disable toolbar buttons depending on listbox
   set_sensitive_toolbar_buttons(bottles.size() > 0);
-  listbox.show_all();
+  // Select the first bottle, when nothing is selected yet
+  if (!bottles.empty() && get_selected_bottle() == nullptr)
+    select_row_bottle(bottles.front());
 }
 
 /**
@@ -161,8 +185,27 @@ void MainWindow::set_wine_bottles(std::list<BottleItem>& bottles)
  */
 void MainWindow::select_row_bottle(BottleItem& bottle)
 {
-  if (!bottle.is_selected())
-    this->listbox.select_row(bottle);
+  auto row = bottle_list_rows.find(&bottle);
+  if (row != bottle_list_rows.end() && !bottle_list_treeview.get_selection()->is_selected(row->second))
+    bottle_list_treeview.get_selection()->select(row->second);
+}
+
+/**
+ * \brief Refresh the bottle row and (when selected) the detailed info panel, after the bottle details are changed
+ * \param[in] bottle - Wine Bottle item object
+ */
+void MainWindow::update_bottle(BottleItem& bottle)
+{
+  auto row = bottle_list_rows.find(&bottle);
+  if (row == bottle_list_rows.end())
+    return;
+  // Only redrawn when visible
+  bottle_list_store->row_changed(bottle_list_store->get_path(row->second), row->second);
+  if (bottle_list_treeview.get_selection()->is_selected(row->second))
+  {
+    set_detailed_info(bottle);
+    set_application_list(bottle.wine_location(), bottle.app_list());
+  }
 }
 
 /**
@@ -178,6 +221,7 @@ void MainWindow::reset_detailed_info()
   wine_location_label.set_text("");
   debug_log_level_label.set_text("");
   wine_last_changed_label.set_text("");
+  disk_usage_label.set_text("");
   audio_driver_label.set_text("");
   virtual_desktop_label.set_text("");
   description_label.set_text("");
@@ -204,6 +248,34 @@ void MainWindow::set_general_config(const GeneralConfigData& config_data)
   general_config_data_ = config_data;
 }
 
+/**
+ * \brief Show the running and queued bottle actions in the status bar
+ * \param[in] jobs Job list
+ */
+void MainWindow::set_jobs(const std::vector<JobInfo>& jobs)
+{
+  std::vector<Glib::ustring> running;
+  int queued_count = 0;
+  for (const JobInfo& job : jobs)
+  {
+    if (job.state == JobState::Running)
+      running.push_back(job.description);
+    else if (job.state == JobState::Queued)
+      queued_count++;
+  }
+
+  statusbar.remove_all_messages();
+  if (running.empty() && queued_count == 0)
+    return;
+
+  Glib::ustring message = "Running: ";
+  for (size_t i = 0; i < running.size(); i++)
+    message += (i > 0 ? ", " : "") + running[i];
+  if (queued_count > 0)
+    message += " (" + std::to_string(queued_count) + " queued)";
+  statusbar.push(message);
+}
+
 /**
  * \brief Show info message. User can only click 'OK'.
  * \param[in] message Show this information message
@@ -306,9 +378,9 @@ void MainWindow::on_new_bottle_button_clicked()
  * \brief Handler when the bottle is created, notify the new bottle assistant.
  * Pass through the signal from the dispatcher to the 'new bottle assistant'.
  */
-void MainWindow::on_new_bottle_created()
+void MainWindow::on_new_bottle_created(std::size_t operation_id)
 {
-  new_bottle_assistant_.bottle_created();
+  new_bottle_assistant_.bottle_created(operation_id);
 }
 
 /**
@@ -382,11 +454,10 @@ void MainWindow::on_run_button_clicked()
  */
 void MainWindow::on_refresh_app_list_button_clicked()
 {
-  Gtk::ListBoxRow* selected_row = listbox.get_selected_row();
-  if (selected_row)
+  BottleItem* current_bottle = get_selected_bottle();
+  if (current_bottle)
   {
     // Refresh the current app list
-    auto current_bottle = dynamic_cast<BottleItem*>(selected_row);
     set_application_list(current_bottle->wine_location(), current_bottle->app_list());
   }
 }
@@ -434,14 +505,13 @@ void MainWindow::on_exec_failure()
  ************************/
 
 /**
- * \brief Change detailed window on listbox row clicked event
- * \param row Row that is selected/clicked
+ * \brief Change detailed window on bottle list selection changed event
  */
-void MainWindow::on_bottle_row_clicked(Gtk::ListBoxRow* row)
+void MainWindow::on_bottle_row_clicked()
 {
-  if (row != nullptr)
+  BottleItem* current_bottle = get_selected_bottle();
+  if (current_bottle != nullptr)
   {
-    auto current_bottle = dynamic_cast<BottleItem*>(row);
     // Set bottle details
     set_detailed_info(*current_bottle);
     // Set application list
@@ -489,7 +559,7 @@ void MainWindow::on_new_bottle_apply()
   new_bottle_assistant_.get_result(name, windows_version, bit, virtual_desktop_resolution, disable_gecko_mono, audio);
 
   // Emit new bottle signal (see dispatcher)
-  new_bottle.emit(name, windows_version, bit, virtual_desktop_resolution, disable_gecko_mono, audio);
+  new_bottle.emit(new_bottle_assistant_.start_operation(), name, windows_version, bit, virtual_desktop_resolution, disable_gecko_mono, audio);
 }
 
 /**
@@ -552,6 +622,20 @@ void MainWindow::set_detailed_info(const BottleItem& bottle)
   Glib::ustring log_level_prefix_str = (!bottle.is_debug_logging()) ? "Logging is disabled - " : "";
   debug_log_level_label.set_markup(log_level_prefix_str + debug_log_level_str);
   wine_last_changed_label.set_text(bottle.wine_last_changed());
+  if (bottle.is_disk_usage_loading())
+  {
+    disk_usage_label.set_text("- Calculating -");
+  }
+  else if (bottle.disk_usage() < 0)
+  {
+    disk_usage_label.set_text("- Unknown -");
+  }
+  else
+  {
+    gchar* disk_usage_str = g_format_size(static_cast<guint64>(bottle.disk_usage()));
+    disk_usage_label.set_text(disk_usage_str);
+    g_free(disk_usage_str);
+  }
   audio_driver_label.set_text(BottleTypes::to_string(bottle.audio_driver()));
   Glib::ustring virtual_desktop_text = (bottle.virtual_desktop().empty()) ? "Disabled" : bottle.virtual_desktop();
   virtual_desktop_label.set_text(virtual_desktop_text);
@@ -826,14 +910,36 @@ void MainWindow::load_stored_window_settings()
  */
 void MainWindow::create_left_panel()
 {
-  // Add scrolled window with listbox to paned
+  // Add scrolled window with the bottle list to paned
   paned.pack1(scrolled_window_listbox);
 
-  // Set function that will add separators between each item
-  listbox.set_header_func(sigc::ptr_fun(&MainWindow::cc_list_box_update_header_func));
-
-  // Add list box to scrolled window
-  scrolled_window_listbox.add(listbox);
+  // Only the bottle is stored in the model, the visible rows are rendered by the cell data functions
+  bottle_list_store = Gtk::ListStore::create(bottle_list_columns);
+  bottle_list_treeview.set_model(bottle_list_store);
+
+  bottle_windows_renderer_pixbuf.set_padding(8, 8);
+  bottle_windows_column.pack_start(bottle_windows_renderer_pixbuf);
+  bottle_windows_column.set_cell_data_func(bottle_windows_renderer_pixbuf,
+                                           sigc::mem_fun(*this, &MainWindow::treeview_set_cell_data_bottle_windows));
+  bottle_status_renderer_pixbuf.set_alignment(0.0, 0.5);
+  bottle_name_status_column.pack_start(bottle_status_renderer_pixbuf, false);
+  bottle_name_status_column.pack_start(bottle_name_status_renderer_text);
+  bottle_name_status_column.set_cell_data_func(bottle_status_renderer_pixbuf,
+                                               sigc::mem_fun(*this, &MainWindow::treeview_set_cell_data_bottle_status_icon));
+  bottle_name_status_column.set_cell_data_func(bottle_name_status_renderer_text,
+                                               sigc::mem_fun(*this, &MainWindow::treeview_set_cell_data_bottle_name_status));
+  bottle_list_treeview.append_column(bottle_windows_column);
+  bottle_list_treeview.append_column(bottle_name_status_column);
+
+  // Separators between each item
+  bottle_list_treeview.set_grid_lines(Gtk::TREE_VIEW_GRID_LINES_HORIZONTAL);
+  bottle_list_treeview.set_headers_visible(false);
+  bottle_list_treeview.set_show_expanders(false);
+  bottle_list_treeview.set_fixed_height_mode(false);
+  bottle_list_treeview.get_selection()->set_mode(Gtk::SELECTION_BROWSE);
+
+  // Add the bottle list to scrolled window
+  scrolled_window_listbox.add(bottle_list_treeview);
 }
 
 /**
@@ -1011,52 +1117,58 @@ void MainWindow::create_right_panel()
   wine_last_changed_label.set_halign(Gtk::Align::ALIGN_START);
   detail_grid.attach(*wine_last_changed_text_label, 0, 12, 2, 1);
   detail_grid.attach_next_to(wine_last_changed_label, *wine_last_changed_text_label, Gtk::PositionType::POS_RIGHT, 1, 1);
+
+  // Disk usage
+  Gtk::Label* disk_usage_text_label = Gtk::manage(new Gtk::Label("Disk Usage:", 0.0, -1));
+  disk_usage_label.set_halign(Gtk::Align::ALIGN_START);
+  detail_grid.attach(*disk_usage_text_label, 0, 13, 2, 1);
+  detail_grid.attach_next_to(disk_usage_label, *disk_usage_text_label, Gtk::PositionType::POS_RIGHT, 1, 1);
   // End Wine
-  detail_grid.attach(*Gtk::manage(new Gtk::Separator(Gtk::ORIENTATION_HORIZONTAL)), 0, 13, 3, 1);
+  detail_grid.attach(*Gtk::manage(new Gtk::Separator(Gtk::ORIENTATION_HORIZONTAL)), 0, 14, 3, 1);
 
   // Audio heading
   Gtk::Image* audio_icon = Gtk::manage(new Gtk::Image());
   audio_icon->set_from_icon_name("audio-speakers", Gtk::IconSize(Gtk::ICON_SIZE_MENU));
   Gtk::Label* audio_text_label = Gtk::manage(new Gtk::Label());
   audio_text_label->set_markup("<b>Audio</b>");
-  detail_grid.attach(*audio_icon, 0, 14, 1, 1);
+  detail_grid.attach(*audio_icon, 0, 15, 1, 1);
   detail_grid.attach_next_to(*audio_text_label, *audio_icon, Gtk::PositionType::POS_RIGHT, 1, 1);
 
   // Audio driver
   Gtk::Label* audio_driver_text_label = Gtk::manage(new Gtk::Label("Audio Driver:", 0.0, -1));
   audio_driver_label.set_halign(Gtk::Align::ALIGN_START);
-  detail_grid.attach(*audio_driver_text_label, 0, 15, 2, 1);
+  detail_grid.attach(*audio_driver_text_label, 0, 16, 2, 1);
   detail_grid.attach_next_to(audio_driver_label, *audio_driver_text_label, Gtk::PositionType::POS_RIGHT, 1, 1);
   // End Audio driver
-  detail_grid.attach(*Gtk::manage(new Gtk::Separator(Gtk::ORIENTATION_HORIZONTAL)), 0, 16, 3, 1);
+  detail_grid.attach(*Gtk::manage(new Gtk::Separator(Gtk::ORIENTATION_HORIZONTAL)), 0, 17, 3, 1);
 
   // Display heading
   Gtk::Image* display_icon = Gtk::manage(new Gtk::Image());
   display_icon->set_from_icon_name("view-fullscreen", Gtk::IconSize(Gtk::ICON_SIZE_MENU));
   Gtk::Label* display_text_label = Gtk::manage(new Gtk::Label());
   display_text_label->set_markup("<b>Display</b>");
-  detail_grid.attach(*display_icon, 0, 17, 1, 1);
+  detail_grid.attach(*display_icon, 0, 18, 1, 1);
   detail_grid.attach_next_to(*display_text_label, *display_icon, Gtk::PositionType::POS_RIGHT, 1, 1);
 
   // Virtual Desktop
   Gtk::Label* virtual_desktop_text_label = Gtk::manage(new Gtk::Label("Virtual Desktop\n(Windowed Mode):", 0.0, -1));
   virtual_desktop_label.set_halign(Gtk::Align::ALIGN_START);
-  detail_grid.attach(*virtual_desktop_text_label, 0, 18, 2, 1);
+  detail_grid.attach(*virtual_desktop_text_label, 0, 19, 2, 1);
   detail_grid.attach_next_to(virtual_desktop_label, *virtual_desktop_text_label, Gtk::PositionType::POS_RIGHT, 1, 1);
   // End Display
-  detail_grid.attach(*Gtk::manage(new Gtk::Separator(Gtk::ORIENTATION_HORIZONTAL)), 0, 19, 3, 1);
+  detail_grid.attach(*Gtk::manage(new Gtk::Separator(Gtk::ORIENTATION_HORIZONTAL)), 0, 20, 3, 1);
 
   // Description heading
   Gtk::Image* description_icon = Gtk::manage(new Gtk::Image());
   description_icon->set_from_icon_name("user-available", Gtk::IconSize(Gtk::ICON_SIZE_MENU));
   Gtk::Label* description_text_label = Gtk::manage(new Gtk::Label());
   description_text_label->set_markup("<b>Description</b>");
-  detail_grid.attach(*description_icon, 0, 20, 1, 1);
+  detail_grid.attach(*description_icon, 0, 21, 1, 1);
   detail_grid.attach_next_to(*description_text_label, *description_icon, Gtk::PositionType::POS_RIGHT, 1, 1);
 
   // Description text
   description_label.set_halign(Gtk::Align::ALIGN_START);
-  detail_grid.attach(description_label, 0, 21, 3, 1);
+  detail_grid.attach(description_label, 0, 22, 3, 1);
   // End Description
 
   // Place inside a scrolled window
@@ -1170,26 +1282,82 @@ void MainWindow::set_sensitive_toolbar_buttons(bool sensitive)
 }
 
 /**
- * \brief Override update header function of GTK Listbox with custom layout
- * \param[in] row
- * \param[in] before
+ * \brief Get the bottle of the selected row in the bottle list
+ * \return Selected bottle, or nullptr when no bottle is selected
  */
-void MainWindow::cc_list_box_update_header_func(Gtk::ListBoxRow* list_box_row, Gtk::ListBoxRow* before)
+BottleItem* MainWindow::get_selected_bottle()
 {
-  GtkWidget* current;
-  GtkListBoxRow* row = list_box_row->gobj();
-  if (before == NULL)
+  Gtk::TreeModel::iterator row = bottle_list_treeview.get_selection()->get_selected();
+  if (!row)
+    return nullptr;
+  return (*row)[bottle_list_columns.bottle];
+}
+
+/**
+ * \brief Get the icon of the bottle list (cached, all the rows share the same icons)
+ * \param[in] filename Image file name
+ * \return Icon, or an empty pointer when the image could not be loaded
+ */
+Glib::RefPtr<Gdk::Pixbuf> MainWindow::get_bottle_list_icon(const string& filename)
+{
+  auto icon = bottle_list_icons.find(filename);
+  if (icon != bottle_list_icons.end())
+    return icon->second;
+
+  Glib::RefPtr<Gdk::Pixbuf> pixbuf;
+  try
   {
-    gtk_list_box_row_set_header(row, NULL);
-    return;
+    pixbuf = Gdk::Pixbuf::create_from_file(Helper::get_image_location(filename));
   }
-  current = gtk_list_box_row_get_header(row);
-  if (current == NULL)
+  catch (const Glib::Error& error)
   {
-    current = gtk_separator_new(GTK_ORIENTATION_HORIZONTAL);
-    gtk_widget_show(current);
-    gtk_list_box_row_set_header(row, current);
+    std::cerr << "ERROR: Could not find icon (" << filename << ") for bottle list: " << error.what() << std::endl;
   }
+  bottle_list_icons.emplace(filename, pixbuf);
+  return pixbuf;
+}
+
+/**
+ * \brief Render Windows logo of the bottle
+ */
+void MainWindow::treeview_set_cell_data_bottle_windows(Gtk::CellRenderer* renderer, const Gtk::TreeModel::iterator& iter)
+{
+  Gtk::CellRendererPixbuf* pixbuf_renderer = (Gtk::CellRendererPixbuf*)renderer;
+  const BottleItem* bottle = (*iter)[bottle_list_columns.bottle];
+  // Lower case, without spaces (eg. windows10_64-bit.png)
+  std::string windows_str = BottleTypes::to_string(bottle->windows()).lowercase();
+  windows_str.erase(std::remove(windows_str.begin(), windows_str.end(), ' '), windows_str.end());
+  std::string bit_str = BottleTypes::to_string(bottle->bit());
+  pixbuf_renderer->property_pixbuf().set_value(get_bottle_list_icon("windows/" + windows_str + "_" + bit_str + ".png"));
+}
+
+/**
+ * \brief Render status icon of the bottle
+ */
+void MainWindow::treeview_set_cell_data_bottle_status_icon(Gtk::CellRenderer* renderer, const Gtk::TreeModel::iterator& iter)
+{
+  Gtk::CellRendererPixbuf* pixbuf_renderer = (Gtk::CellRendererPixbuf*)renderer;
+  const BottleItem* bottle = (*iter)[bottle_list_columns.bottle];
+  Glib::RefPtr<Gdk::Pixbuf> status_icon;
+  if (!bottle->is_loading())
+    status_icon = get_bottle_list_icon((bottle->status()) ? "ready.png" : "not_ready.png");
+  pixbuf_renderer->property_pixbuf().set_value(status_icon);
+}
+
+/**
+ * \brief Render name + status text of the bottle
+ */
+void MainWindow::treeview_set_cell_data_bottle_name_status(Gtk::CellRenderer* renderer, const Gtk::TreeModel::iterator& iter)
+{
+  Gtk::CellRendererText* text_renderer = (Gtk::CellRendererText*)renderer;
+  const BottleItem* bottle = (*iter)[bottle_list_columns.bottle];
+  Glib::ustring name = (!bottle->name().empty()) ? bottle->name() : bottle->folder_name(); // Fallback to folder name
+  Glib::ustring status_text = "Ready";
+  if (bottle->is_loading())
+    status_text = "Loading...";
+  else if (!bottle->status())
+    status_text = "Not Ready";
+  text_renderer->property_markup().set_value("<span size=\"medium\"><b>" + Glib::Markup::escape_text(name) + "</b></span>\n" + status_text);
 }
 
 /**
@@ -0,0 +1,75 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    mapped_file.cc
+ * \brief   Read-only memory-mapped file
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "mapped_file.h"
+#include <fcntl.h>
+#include <stdexcept>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+/**
+ * \brief Map the file into memory.
+ * Wine replaces the registry files by renaming a new file over the old one, so the mapping stays valid while Wine is saving.
+ * \param[in] file_path File to be mapped
+ * \throws runtime_error when the file could not be opened or mapped
+ */
+MappedFile::MappedFile(const std::string& file_path) : data_(nullptr), size_(0)
+{
+  int fd = open(file_path.c_str(), O_RDONLY | O_CLOEXEC);
+  if (fd == -1)
+  {
+    throw std::runtime_error("Could not open file: " + file_path);
+  }
+  struct stat file_stat;
+  if (fstat(fd, &file_stat) == -1)
+  {
+    close(fd);
+    throw std::runtime_error("Could not read file status: " + file_path);
+  }
+  size_ = static_cast<std::size_t>(file_stat.st_size);
+  // Nothing to map for an empty file
+  if (size_ > 0)
+  {
+    data_ = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+    if (data_ == MAP_FAILED)
+    {
+      data_ = nullptr;
+      size_ = 0;
+      close(fd);
+      throw std::runtime_error("Could not map file into memory: " + file_path);
+    }
+    // The file is parsed from start to end
+    madvise(data_, size_, MADV_SEQUENTIAL);
+  }
+  // The mapping stays valid after closing the file descriptor
+  close(fd);
+}
+
+/**
+ * \brief Unmap the file from memory
+ */
+MappedFile::~MappedFile()
+{
+  if (data_ != nullptr)
+  {
+    munmap(data_, size_);
+  }
+}
@@ -175,8 +175,8 @@ void PreferencesWindow::on_cancel_button_clicked()
  */
 void PreferencesWindow::on_save_button_clicked()
 {
-  // Save preferences to disk
-  GeneralConfigData general_config;
+  // Save preferences to disk (settings not shown in the preferences window are kept)
+  GeneralConfigData general_config = GeneralConfigFile::read_config_file();
   general_config.default_folder = default_folder_entry.get_text();
   general_config.display_default_wine_machine = display_default_wine_machine_check.get_active();
   general_config.prefer_wine64 = prefer_wine64_check.get_active();
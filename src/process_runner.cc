@@ -0,0 +1,210 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    process_runner.cc
+ * \brief   Run a program without a shell (posix_spawn)
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "process_runner.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <map>
+#include <poll.h>
+#include <spawn.h>
+#include <stdexcept>
+#include <sys/wait.h>
+#include <unistd.h>
+
+extern char** environ;
+
+static const std::size_t ReadChunkSize = 64 * 1024; /*!< Output is read in chunks of 64 KiB */
+
+/**
+ * \brief Environment of the child process: the environment of WineGUI, with the extra variables added/overridden
+ * \param[in] extra_environment Extra environment variables (NAME=value)
+ * \return Environment variables (NAME=value)
+ */
+static std::vector<std::string> build_environment(const std::vector<std::string>& extra_environment)
+{
+  std::map<std::string, std::string> variables;
+  for (char** variable = environ; variable != nullptr && *variable != nullptr; ++variable)
+  {
+    std::string_view entry(*variable);
+    variables.emplace(entry.substr(0, entry.find('=')), entry);
+  }
+  for (const std::string& entry : extra_environment)
+  {
+    variables.insert_or_assign(entry.substr(0, entry.find('=')), entry);
+  }
+  std::vector<std::string> environment;
+  environment.reserve(variables.size());
+  for (auto& variable : variables)
+  {
+    environment.push_back(std::move(variable.second));
+  }
+  return environment;
+}
+
+/**
+ * \brief Pointers to the strings, terminated by a null pointer (as expected by posix_spawn)
+ */
+static std::vector<char*> to_c_array(std::vector<std::string>& strings)
+{
+  std::vector<char*> pointers;
+  pointers.reserve(strings.size() + 1);
+  for (std::string& str : strings)
+  {
+    pointers.push_back(str.data());
+  }
+  pointers.push_back(nullptr);
+  return pointers;
+}
+
+/**
+ * \brief Run a program and wait until it is finished (run this method async). The program is searched in PATH.
+ * \param[in] argv Program followed by its arguments
+ * \param[in] options Environment and output options
+ * \throws runtime_error when the program could not be started
+ * \return Exit code and output of the program
+ */
+ProcessResult ProcessRunner::run(const std::vector<std::string>& argv, const ProcessOptions& options)
+{
+  ProcessResult result{0, ""};
+  result.exit_code = run(argv, [&result](std::string_view output) { result.output.append(output); }, options);
+  return result;
+}
+
+/**
+ * \brief Run a program and wait until it is finished (run this method async), the output is passed to the callback instead of buffered.
+ * The program is searched in PATH.
+ * \param[in] argv Program followed by its arguments
+ * \param[in] output_callback Called for each chunk of output (from this thread)
+ * \param[in] options Environment and output options
+ * \throws runtime_error when the program could not be started
+ * \return Exit code, 128 + signal number when the program is terminated by a signal
+ */
+int ProcessRunner::run(const std::vector<std::string>& argv, const OutputCallback& output_callback, const ProcessOptions& options)
+{
+  if (argv.empty())
+  {
+    throw std::runtime_error("No program given to run");
+  }
+  std::vector<std::string> arguments = argv;
+  std::vector<std::string> environment = build_environment(options.environment);
+  std::vector<char*> c_arguments = to_c_array(arguments);
+  std::vector<char*> c_environment = to_c_array(environment);
+
+  int pipe_fds[2] = {-1, -1};
+  if (!options.discard_output && pipe2(pipe_fds, O_CLOEXEC) != 0)
+  {
+    throw std::runtime_error("Could not create a pipe for: " + argv.front() + " (" + std::strerror(errno) + ")");
+  }
+
+  posix_spawn_file_actions_t file_actions;
+  posix_spawn_file_actions_init(&file_actions);
+  if (options.discard_output)
+  {
+    posix_spawn_file_actions_addopen(&file_actions, STDOUT_FILENO, "/dev/null", O_WRONLY, 0);
+    posix_spawn_file_actions_adddup2(&file_actions, STDOUT_FILENO, STDERR_FILENO);
+  }
+  else
+  {
+    // Close-on-exec is cleared for the duplicated descriptors, the pipe itself is closed in the child
+    posix_spawn_file_actions_adddup2(&file_actions, pipe_fds[1], STDOUT_FILENO);
+    if (options.merge_stderr)
+      posix_spawn_file_actions_adddup2(&file_actions, pipe_fds[1], STDERR_FILENO);
+  }
+
+  pid_t pid = 0;
+  int spawn_error = posix_spawnp(&pid, c_arguments.front(), &file_actions, nullptr, c_arguments.data(), c_environment.data());
+  posix_spawn_file_actions_destroy(&file_actions);
+  if (!options.discard_output)
+    close(pipe_fds[1]);
+  if (spawn_error != 0)
+  {
+    if (!options.discard_output)
+      close(pipe_fds[0]);
+    throw std::runtime_error("Could not start: " + argv.front() + " (" + std::strerror(spawn_error) + ")");
+  }
+
+  if (!options.discard_output)
+  {
+    read_output(pipe_fds[0], output_callback, options);
+    close(pipe_fds[0]);
+  }
+  return wait_for_exit(pid);
+}
+
+/**
+ * \brief Read the output until the write end of the pipe is closed (all the processes writing to it are stopped)
+ * \param[in] fd Read end of the pipe
+ * \param[in] output_callback Called for each chunk of output
+ * \param[in] options Idle timeout and callback
+ */
+void ProcessRunner::read_output(int fd, const OutputCallback& output_callback, const ProcessOptions& options)
+{
+  bool has_idle_callback = options.idle_callback && options.idle_timeout.count() > 0;
+  int poll_timeout = has_idle_callback ? static_cast<int>(options.idle_timeout.count()) : -1;
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+  std::vector<char> buffer(ReadChunkSize);
+  struct pollfd poll_fd = {fd, POLLIN, 0};
+  while (true)
+  {
+    ssize_t size = read(fd, buffer.data(), buffer.size());
+    if (size > 0)
+    {
+      output_callback(std::string_view(buffer.data(), static_cast<std::size_t>(size)));
+    }
+    else if (size == 0)
+    {
+      break; // End of output
+    }
+    else if (errno == EAGAIN || errno == EWOULDBLOCK)
+    {
+      // Wait for more output
+      int ready = poll(&poll_fd, 1, poll_timeout);
+      if (ready == 0)
+        options.idle_callback();
+      else if (ready < 0 && errno != EINTR)
+        break;
+    }
+    else if (errno != EINTR)
+    {
+      break;
+    }
+  }
+}
+
+/**
+ * \brief Wait until the process is terminated
+ * \param[in] pid Process ID
+ * \return Exit code, 128 + signal number when the process is terminated by a signal
+ */
+int ProcessRunner::wait_for_exit(pid_t pid)
+{
+  int status = 0;
+  while (waitpid(pid, &status, 0) < 0)
+  {
+    if (errno != EINTR)
+      return -1;
+  }
+  if (WIFEXITED(status))
+    return WEXITSTATUS(status);
+  if (WIFSIGNALED(status))
+    return 128 + WTERMSIG(status);
+  return -1;
+}
@@ -0,0 +1,150 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    reg_escape.cc
+ * \brief   Decoder of the escaped data in the Wine registry files
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "reg_escape.h"
+#include <array>
+#include <cstring>
+
+/**
+ * \brief Lookup tables used for unescaping the registry data, indexed by the (unsigned) character
+ */
+struct EscapeTables
+{
+  std::array<char, 256> simple_escape{};    /*!< Control character of a simple escape (eg. 'n' -> '\n'), zero when not a simple escape */
+  std::array<signed char, 256> hex_value{}; /*!< Value of a hexadecimal digit, -1 when not a hexadecimal digit */
+};
+
+static constexpr EscapeTables make_escape_tables()
+{
+  EscapeTables tables;
+  tables.simple_escape['a'] = '\a';
+  tables.simple_escape['b'] = '\b';
+  tables.simple_escape['e'] = '\x1b';
+  tables.simple_escape['f'] = '\f';
+  tables.simple_escape['n'] = '\n';
+  tables.simple_escape['r'] = '\r';
+  tables.simple_escape['t'] = '\t';
+  tables.simple_escape['v'] = '\v';
+  for (auto& value : tables.hex_value)
+    value = -1;
+  for (int i = 0; i < 10; ++i)
+    tables.hex_value['0' + i] = static_cast<signed char>(i);
+  for (int i = 0; i < 6; ++i)
+  {
+    tables.hex_value['a' + i] = static_cast<signed char>(10 + i);
+    tables.hex_value['A' + i] = static_cast<signed char>(10 + i);
+  }
+  return tables;
+}
+static constexpr EscapeTables Escape = make_escape_tables();
+
+/**
+ * \brief Parse an escaped Wine registry key data back into an UTF-8 string
+ * The code is adopted from the parse_strW() method:
+ * https://source.winehq.org/git/wine.git/blob/refs/heads/master:/server/unicode.c#l101
+ *
+ * Data without any escape is returned as-is. Otherwise the output is written directly into a pre-sized buffer,
+ * an escape sequence is never shorter than its UTF-8 result (eg. \x7ff is 5 chars, 2 bytes UTF-8).
+ * \param[in] src Key data to be unescaped
+ * \return UTF-8 string
+ */
+std::string RegEscape::unescape(std::string_view src)
+{
+  const char* p = static_cast<const char*>(std::memchr(src.data(), '\\', src.size()));
+  if (p == nullptr)
+    return std::string(src);
+
+  auto hex_value = [](char ch) -> int { return Escape.hex_value[static_cast<unsigned char>(ch)]; };
+  auto is_octal = [](char ch) -> bool { return ch >= '0' && ch <= '7'; };
+  // Wine only writes 16-bit characters (max. 4 hex digits), so at most 3 bytes UTF-8
+  auto write_utf8 = [](char*& out, unsigned int wc) {
+    if (wc <= 0x7f)
+    {
+      *out++ = static_cast<char>(wc);
+    }
+    else if (wc <= 0x7ff)
+    {
+      *out++ = static_cast<char>(0xc0 | (wc >> 6));
+      *out++ = static_cast<char>(0x80 | (wc & 0x3f));
+    }
+    else
+    {
+      *out++ = static_cast<char>(0xe0 | (wc >> 12));
+      *out++ = static_cast<char>(0x80 | ((wc >> 6) & 0x3f));
+      *out++ = static_cast<char>(0x80 | (wc & 0x3f));
+    }
+  };
+
+  std::string dest;
+  dest.resize(src.size());
+  // Copy everything before the first escape at once
+  std::size_t prefix_length = static_cast<std::size_t>(p - src.data());
+  std::memcpy(dest.data(), src.data(), prefix_length);
+  char* out = dest.data() + prefix_length;
+
+  const char* end = src.data() + src.size();
+  while (p < end)
+  {
+    if (*p != '\\')
+    {
+      *out++ = *p++;
+      continue;
+    }
+    p++;
+    if (p == end)
+      break;
+
+    char simple = Escape.simple_escape[static_cast<unsigned char>(*p)];
+    if (simple != 0)
+    {
+      *out++ = simple;
+      p++;
+    }
+    else if (*p == 'x')
+    {
+      // hex escape
+      p++;
+      if (p == end || hex_value(*p) < 0)
+      {
+        *out++ = 'x';
+        continue;
+      }
+      unsigned int wch = static_cast<unsigned int>(hex_value(*p++));
+      for (int i = 0; i < 3 && p < end && hex_value(*p) >= 0; ++i)
+        wch = (wch * 16) + static_cast<unsigned int>(hex_value(*p++));
+      write_utf8(out, wch);
+    }
+    else if (is_octal(*p))
+    {
+      // octal escape
+      unsigned int wch = static_cast<unsigned int>(*p++ - '0');
+      for (int i = 0; i < 2 && p < end && is_octal(*p); ++i)
+        wch = (wch * 8) + static_cast<unsigned int>(*p++ - '0');
+      write_utf8(out, wch);
+    }
+    else
+    {
+      // unrecognized escape: keep the character
+      *out++ = *p++;
+    }
+  }
+  dest.resize(static_cast<std::size_t>(out - dest.data()));
+  return dest;
+}
@@ -0,0 +1,469 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    registry_index.cc
+ * \brief   Parsed in-memory index of a Wine registry file
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "registry_index.h"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
+#include <limits>
+#include <stdexcept>
+
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define REGISTRY_SIMD_SCAN
+#endif
+
+/**
+ * \brief Find the next section header, thus a '[' at the start of a line
+ * Portable version, memchr is already vectorized by libc for the new line search.
+ * \param[in] data Registry file data
+ * \param[in] from Position to start searching from (>= 1)
+ * \return Position of the '[' character or data.size() when there is no next section
+ */
+static std::size_t find_section_header_scalar(std::string_view data, std::size_t from)
+{
+  while (from < data.size())
+  {
+    const char* new_line = static_cast<const char*>(std::memchr(data.data() + from - 1, '\n', data.size() - from));
+    if (new_line == nullptr)
+      break;
+    from = static_cast<std::size_t>(new_line - data.data()) + 1;
+    if (data[from] == '[')
+      return from;
+    ++from;
+  }
+  return data.size();
+}
+
+#ifdef REGISTRY_SIMD_SCAN
+/**
+ * \brief Find the next section header using SSE2 (16 bytes per iteration)
+ * Compares the '\\n' bytes and the '[' bytes (shifted by one) at once, only a match in both is a section header.
+ */
+static std::size_t find_section_header_sse2(std::string_view data, std::size_t from)
+{
+  const char* base = data.data();
+  const __m128i new_line = _mm_set1_epi8('\n');
+  const __m128i bracket = _mm_set1_epi8('[');
+  std::size_t pos = from - 1;
+  for (; pos + 17 <= data.size(); pos += 16)
+  {
+    __m128i current = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + pos));
+    __m128i next = _mm_loadu_si128(reinterpret_cast<const __m128i*>(base + pos + 1));
+    unsigned int mask = static_cast<unsigned int>(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(current, new_line), _mm_cmpeq_epi8(next, bracket))));
+    if (mask != 0)
+      return pos + static_cast<std::size_t>(__builtin_ctz(mask)) + 1;
+  }
+  return find_section_header_scalar(data, pos + 1);
+}
+
+/**
+ * \brief Find the next section header using AVX2 (32 bytes per iteration)
+ */
+__attribute__((target("avx2"))) static std::size_t find_section_header_avx2(std::string_view data, std::size_t from)
+{
+  const char* base = data.data();
+  const __m256i new_line = _mm256_set1_epi8('\n');
+  const __m256i bracket = _mm256_set1_epi8('[');
+  std::size_t pos = from - 1;
+  for (; pos + 33 <= data.size(); pos += 32)
+  {
+    __m256i current = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + pos));
+    __m256i next = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(base + pos + 1));
+    unsigned int mask =
+        static_cast<unsigned int>(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(current, new_line), _mm256_cmpeq_epi8(next, bracket))));
+    if (mask != 0)
+      return pos + static_cast<std::size_t>(__builtin_ctz(mask)) + 1;
+  }
+  return find_section_header_sse2(data, pos + 1);
+}
+#endif
+
+using FindSectionHeaderFunc = std::size_t (*)(std::string_view, std::size_t);
+
+/**
+ * \brief Select the fastest section header scanner supported by the CPU, at runtime
+ * \return Function pointer to scanner
+ */
+static FindSectionHeaderFunc select_section_header_scanner()
+{
+#ifdef REGISTRY_SIMD_SCAN
+  if (__builtin_cpu_supports("avx2"))
+    return find_section_header_avx2;
+  return find_section_header_sse2; // SSE2 is always available on x86-64
+#else
+  return find_section_header_scalar;
+#endif
+}
+
+static const FindSectionHeaderFunc find_section_header = select_section_header_scanner();
+
+// Binary snapshot format: SnapshotHeader, followed by the meta data entries, the key section entries and the string data
+static constexpr char SnapshotMagic[8] = {'W', 'G', 'R', 'E', 'G', 'I', 'D', 'X'};
+static constexpr std::uint32_t SnapshotVersion = 1; /*!< Increase when the snapshot layout changes */
+
+/**
+ * \brief Snapshot file header, the source fields must match the registry file on disk
+ */
+struct SnapshotHeader
+{
+  char magic[8];
+  std::uint32_t version;
+  std::uint32_t meta_count;
+  std::uint32_t section_count;
+  std::uint32_t reserved;
+  std::uint64_t source_inode;
+  std::uint64_t source_size;
+  std::int64_t source_mtime_sec;
+  std::int64_t source_mtime_nsec;
+};
+
+/**
+ * \brief Snapshot entry, offsets are relative to the start of the string data
+ */
+struct SnapshotEntry
+{
+  std::uint32_t name_offset;
+  std::uint32_t name_length;
+  std::uint32_t data_offset;
+  std::uint32_t data_length;
+};
+
+/**
+ * \brief Fill the snapshot header source fields from the registry file status
+ * \param[in,out] header Snapshot header
+ * \param[in] source_stat File status of the registry text file
+ */
+static void set_snapshot_source(SnapshotHeader& header, const struct stat& source_stat)
+{
+  header.source_inode = static_cast<std::uint64_t>(source_stat.st_ino);
+  header.source_size = static_cast<std::uint64_t>(source_stat.st_size);
+  header.source_mtime_sec = static_cast<std::int64_t>(source_stat.st_mtim.tv_sec);
+  header.source_mtime_nsec = static_cast<std::int64_t>(source_stat.st_mtim.tv_nsec);
+}
+
+/**
+ * \brief Map the registry file and index the key sections
+ * Only the section headers are located (SIMD accelerated when available), the key lines itself are split on-demand during a query.
+ * \param[in] file_path File path of registry
+ * \throws runtime_error when we couldn't load the Windows registry
+ */
+RegistryIndex::RegistryIndex(const std::string& file_path) : file_(file_path)
+{
+  std::string_view data = file_.data();
+  std::size_t header = find_section_header(data, 1);
+
+  // Meta data at the top of the registry file (before the first key), eg. #arch=win32
+  for (std::string_view line : split_lines(data.substr(0, header), false))
+  {
+    std::size_t pos = line.find('=');
+    if (line.starts_with('#') && pos != std::string_view::npos)
+    {
+      meta_data_.emplace(line.substr(1, pos - 1), line.substr(pos + 1));
+    }
+  }
+
+  while (header < data.size())
+  {
+    // New key section, eg. [Software\\\\Wine] 1672527600
+    std::size_t next_header = find_section_header(data, header + 1);
+    std::string_view section = data.substr(header, next_header - header);
+    std::size_t header_end = section.find('\n');
+    std::string_view header_line = section.substr(0, header_end);
+    std::size_t end_pos = header_line.rfind(']');
+    std::string_view key_name = (end_pos != std::string_view::npos) ? header_line.substr(0, end_pos + 1) : header_line;
+    sections_.push_back((header_end != std::string_view::npos) ? section.substr(header_end + 1) : std::string_view());
+    key_index_.emplace(key_name, sections_.size() - 1);
+    header = next_header;
+  }
+}
+
+/**
+ * \brief Map a binary snapshot of the index, no registry text is parsed
+ * \param[in] snapshot_path File path of the snapshot
+ * \param[in] source_stat File status of the registry text file the snapshot should belong to
+ * \throws runtime_error when the snapshot could not be loaded, has another version or is stale
+ */
+RegistryIndex::RegistryIndex(const std::string& snapshot_path, const struct stat& source_stat) : file_(snapshot_path)
+{
+  std::string_view data = file_.data();
+  SnapshotHeader header;
+  SnapshotHeader expected{};
+  set_snapshot_source(expected, source_stat);
+  if (data.size() < sizeof(header))
+    throw std::runtime_error("Registry snapshot is too small");
+  std::memcpy(&header, data.data(), sizeof(header));
+  if (std::memcmp(header.magic, SnapshotMagic, sizeof(SnapshotMagic)) != 0 || header.version != SnapshotVersion)
+    throw std::runtime_error("Registry snapshot version mismatch");
+  if (header.source_inode != expected.source_inode || header.source_size != expected.source_size ||
+      header.source_mtime_sec != expected.source_mtime_sec || header.source_mtime_nsec != expected.source_mtime_nsec)
+    throw std::runtime_error("Registry snapshot is stale");
+
+  std::size_t entry_count = static_cast<std::size_t>(header.meta_count) + header.section_count;
+  if ((data.size() - sizeof(header)) / sizeof(SnapshotEntry) < entry_count)
+    throw std::runtime_error("Registry snapshot is truncated");
+  std::string_view strings = data.substr(sizeof(header) + (entry_count * sizeof(SnapshotEntry)));
+  auto slice = [&strings](std::uint32_t offset, std::uint32_t length) -> std::string_view {
+    if (offset > strings.size() || length > strings.size() - offset)
+      throw std::runtime_error("Registry snapshot is corrupt");
+    return strings.substr(offset, length);
+  };
+
+  sections_.reserve(header.section_count);
+  for (std::size_t i = 0; i < entry_count; ++i)
+  {
+    SnapshotEntry entry;
+    std::memcpy(&entry, data.data() + sizeof(header) + (i * sizeof(entry)), sizeof(entry));
+    std::string_view name = slice(entry.name_offset, entry.name_length);
+    std::string_view value = slice(entry.data_offset, entry.data_length);
+    if (i < header.meta_count)
+    {
+      meta_data_.emplace(name, value);
+    }
+    else
+    {
+      sections_.push_back(value);
+      key_index_.emplace(name, sections_.size() - 1);
+    }
+  }
+}
+
+/**
+ * \brief Load a binary snapshot of the index, created by to_snapshot()
+ * \param[in] snapshot_path File path of the snapshot
+ * \param[in] source_stat File status of the registry text file the snapshot should belong to
+ * \return Registry index or nullptr when the snapshot is missing, has another version or is stale
+ */
+std::shared_ptr<const RegistryIndex> RegistryIndex::from_snapshot(const std::string& snapshot_path, const struct stat& source_stat)
+{
+  try
+  {
+    return std::shared_ptr<const RegistryIndex>(new RegistryIndex(snapshot_path, source_stat));
+  }
+  catch (const std::runtime_error&)
+  {
+    return nullptr;
+  }
+}
+
+/**
+ * \brief Serialize the index into the compact binary snapshot format.
+ * Comment lines within the keys (eg. #time=1d96a8b1c2e3f4a) are not stored.
+ * \param[in] source_stat File status of the registry text file this index is parsed from
+ * \return Snapshot data or empty string when the registry is too large for the snapshot format
+ */
+std::string RegistryIndex::to_snapshot(const struct stat& source_stat) const
+{
+  // Sections in file order, duplicated key names are unreachable anyway
+  std::vector<std::string_view> key_names(sections_.size());
+  for (const auto& [key_name, index] : key_index_)
+  {
+    key_names.at(index) = key_name;
+  }
+
+  std::vector<SnapshotEntry> entries;
+  std::string strings;
+  auto add_string = [&strings](std::string_view str) -> std::uint32_t {
+    std::size_t offset = strings.size();
+    strings.append(str);
+    return static_cast<std::uint32_t>(offset);
+  };
+  for (const auto& [name, value] : meta_data_)
+  {
+    std::uint32_t name_offset = add_string(name);
+    std::uint32_t data_offset = add_string(value);
+    entries.push_back({name_offset, static_cast<std::uint32_t>(name.size()), data_offset, static_cast<std::uint32_t>(value.size())});
+  }
+  std::uint32_t section_count = 0;
+  for (std::size_t i = 0; i < sections_.size(); ++i)
+  {
+    if (key_names.at(i).empty())
+      continue;
+    std::uint32_t name_offset = add_string(key_names.at(i));
+    std::size_t data_offset = strings.size();
+    for (std::string_view line : split_lines(sections_.at(i)))
+    {
+      if (line.starts_with('#'))
+        continue;
+      strings.append(line);
+      strings.push_back('\n');
+    }
+    entries.push_back({name_offset, static_cast<std::uint32_t>(key_names.at(i).size()), static_cast<std::uint32_t>(data_offset),
+                       static_cast<std::uint32_t>(strings.size() - data_offset)});
+    ++section_count;
+  }
+  if (strings.size() > std::numeric_limits<std::uint32_t>::max())
+    return "";
+
+  SnapshotHeader header{};
+  std::memcpy(header.magic, SnapshotMagic, sizeof(SnapshotMagic));
+  header.version = SnapshotVersion;
+  header.meta_count = static_cast<std::uint32_t>(meta_data_.size());
+  header.section_count = section_count;
+  set_snapshot_source(header, source_stat);
+
+  std::string output;
+  output.reserve(sizeof(header) + (entries.size() * sizeof(SnapshotEntry)) + strings.size());
+  output.append(reinterpret_cast<const char*>(&header), sizeof(header));
+  output.append(reinterpret_cast<const char*>(entries.data()), entries.size() * sizeof(SnapshotEntry));
+  output.append(strings);
+  return output;
+}
+
+/**
+ * \brief Get the raw lines of a specific key (still escaped, see RegEscape::unescape)
+ * \param[in] key_name Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \return Lines of the key or empty list when the key is not found
+ */
+std::vector<std::string_view> RegistryIndex::get_key_lines(std::string_view key_name) const
+{
+  const std::string_view* section = find_section(key_name);
+  return (section != nullptr) ? split_lines(*section) : std::vector<std::string_view>();
+}
+
+/**
+ * \brief Get a specific value from the registry
+ * \param[in] key_name   Full or part of the path of the key, always starting with '[' (eg. [Software\\\\Wine\\\\Explorer])
+ * \param[in] value_name Specifies the registry value name (eg. Desktop)
+ * \return Data of value name (without quotes) or empty string when not found
+ */
+std::string RegistryIndex::get_value(std::string_view key_name, std::string_view value_name) const
+{
+  return find_value(find_section(key_name), value_name);
+}
+
+/**
+ * \brief Get multiple values from the registry at once, the key section is only searched once for consecutive queries on the same key
+ * \param[in] key_value_names List of key name + value name pairs (eg. [Software\\\\Wine] + Version)
+ * \return Data of each value name (without quotes), in the same order as the input. Empty string when not found.
+ */
+std::vector<std::string> RegistryIndex::get_values(const std::vector<std::pair<std::string, std::string>>& key_value_names) const
+{
+  std::vector<std::string> output;
+  output.reserve(key_value_names.size());
+  const std::string* previous_key_name = nullptr;
+  const std::string_view* section = nullptr;
+  for (const auto& [key_name, value_name] : key_value_names)
+  {
+    if (previous_key_name == nullptr || *previous_key_name != key_name)
+    {
+      section = find_section(key_name);
+      previous_key_name = &key_name;
+    }
+    output.push_back(find_value(section, value_name));
+  }
+  return output;
+}
+
+/**
+ * \brief Get a meta value from the top of the registry file
+ * \param[in] meta_value_name Specifies the registry meta value name (eg. arch)
+ * \return Data of the meta value name or empty string when not found
+ */
+std::string RegistryIndex::get_meta_data(std::string_view meta_value_name) const
+{
+  auto it = meta_data_.find(meta_value_name);
+  return (it != meta_data_.end()) ? remove_quotes(it->second) : "";
+}
+
+/**
+ * \brief Find the first key (in file order) that starts with the given key name
+ * \param[in] key_name Full or part of the path of the key
+ * \return Pointer to section body or nullptr when not found
+ */
+const std::string_view* RegistryIndex::find_section(std::string_view key_name) const
+{
+  std::size_t index = std::string::npos;
+  for (auto it = key_index_.lower_bound(key_name); it != key_index_.end() && it->first.starts_with(key_name); ++it)
+  {
+    index = std::min(index, it->second);
+  }
+  return (index != std::string::npos) ? &sections_.at(index) : nullptr;
+}
+
+/**
+ * \brief Search a value name within the key section
+ * \param[in] section Section body (can be nullptr)
+ * \param[in] value_name Specifies the registry value name (eg. Desktop)
+ * \return Data of value name (without quotes) or empty string when not found
+ */
+std::string RegistryIndex::find_value(const std::string_view* section, std::string_view value_name)
+{
+  if (section == nullptr)
+    return "";
+  for (std::string_view line : split_lines(*section))
+  {
+    if (!line.starts_with('"'))
+      continue;
+    // Search for the closing quote of the value name, skip escaped characters
+    std::size_t pos = 1;
+    while (pos < line.size() && line[pos] != '"')
+    {
+      pos += (line[pos] == '\\') ? 2 : 1;
+    }
+    if (pos + 1 < line.size() && line[pos + 1] == '=' && line.substr(1, pos - 1) == value_name)
+    {
+      return remove_quotes(line.substr(pos + 2));
+    }
+  }
+  return "";
+}
+
+/**
+ * \brief Split the lines of a section body, by default up to the first empty line (end of key section in registry)
+ * \param[in] body Section body
+ * \param[in] stop_at_empty_line Stop at the first empty line (default: true), otherwise empty lines are skipped
+ * \return Lines (without new line characters)
+ */
+std::vector<std::string_view> RegistryIndex::split_lines(std::string_view body, bool stop_at_empty_line)
+{
+  std::vector<std::string_view> lines;
+  std::size_t start = 0;
+  while (start < body.size())
+  {
+    std::size_t end = body.find('\n', start);
+    if (end == std::string_view::npos)
+      end = body.size();
+    std::string_view line = body.substr(start, end - start);
+    start = end + 1;
+    if (line.empty())
+    {
+      if (stop_at_empty_line)
+        break;
+      continue;
+    }
+    lines.push_back(line);
+  }
+  return lines;
+}
+
+/**
+ * \brief Copy the registry data, without the quotes
+ * \param[in] data Raw registry data
+ * \return Data without quotes
+ */
+std::string RegistryIndex::remove_quotes(std::string_view data)
+{
+  std::string output;
+  output.reserve(data.size());
+  std::copy_if(data.begin(), data.end(), std::back_inserter(output), [](char c) { return c != '"'; });
+  return output;
+}
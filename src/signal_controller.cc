@@ -54,18 +54,18 @@ SignalController::SignalController(BottleManager& manager,
       remove_app_window_(remove_app_window),
       bottle_created_dispatcher_(),
       error_message_created_dispatcher_(),
-      thread_bottle_manager_(nullptr)
+      running_bottle_operations_(0)
 {
   // Nothing
 }
 
 /**
- * \brief Destructor, join (wait for) running threads, if applicable, to avoid zombies
+ * \brief Destructor, wait for the running bottle operations, they signal back to this controller
  */
 SignalController::~SignalController()
 {
-  // To avoid zombie threads
-  this->cleanup_bottle_manager_thread();
+  std::unique_lock<std::mutex> lock(bottle_operations_mutex_);
+  bottle_operations_finished_.wait(lock, [this] { return running_bottle_operations_ == 0; });
 }
 
 /**
@@ -92,7 +92,7 @@ void SignalController::dispatch_signals()
   menu_.preferences.connect(sigc::mem_fun(preferences_window_, &PreferencesWindow::show));
   menu_.quit.connect(
       sigc::mem_fun(*main_window_, &MainWindow::on_hide_window)); /*!< When quit button is pressed, hide main window and therefore closes the app */
-  menu_.refresh_view.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), false));
+  menu_.refresh_view.connect(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles));
   menu_.new_bottle.connect(sigc::mem_fun(*main_window_, &MainWindow::on_new_bottle_button_clicked));
   menu_.run.connect(sigc::mem_fun(*main_window_, &MainWindow::on_run_button_clicked));
   menu_.edit_bottle.connect(sigc::mem_fun(edit_window_, &BottleEditWindow::show));
@@ -120,13 +120,14 @@ void SignalController::dispatch_signals()
   manager_.reset_active_bottle.connect(sigc::mem_fun(*main_window_, &MainWindow::reset_application_list));
   // Removed bottle signal from the manager
   manager_.bottle_removed.connect(sigc::mem_fun(edit_window_, &BottleEditWindow::bottle_removed));
+  manager_.jobs_changed.connect(sigc::mem_fun(this, &SignalController::on_jobs_changed));
   // Package install finished (in settings window), close the busy dialog & refresh the settings window
   manager_.finished_package_install_dispatcher.connect(sigc::mem_fun(*main_window_, &MainWindow::close_busy_dialog));
   manager_.finished_package_install_dispatcher.connect(sigc::mem_fun(configure_window_, &BottleConfigureWindow::update_installed));
 
   // Menu / Toolbar actions
   main_window_->new_bottle.connect(sigc::mem_fun(this, &SignalController::on_new_bottle));
-  main_window_->finished_new_bottle.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), false));
+  main_window_->finished_new_bottle.connect(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles));
   main_window_->run_executable.connect(sigc::mem_fun(manager_, &BottleManager::run_executable));
   main_window_->run_program.connect(sigc::mem_fun(manager_, &BottleManager::run_program));
   main_window_->show_edit_window.connect(sigc::mem_fun(edit_window_, &BottleEditWindow::show));
@@ -169,67 +170,102 @@ void SignalController::dispatch_signals()
   configure_window_.visual_cpp_package.connect(sigc::mem_fun(manager_, &BottleManager::install_visual_cpp_package));
 
   // Add new application Window
-  add_app_window_.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), false));
+  add_app_window_.config_saved.connect(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles));
 
   // Remove application Window
-  remove_app_window_.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), false));
+  remove_app_window_.config_saved.connect(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles));
 
   // WineGUI Preference Window
-  preferences_window_.config_saved.connect(sigc::bind(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles), false));
+  preferences_window_.config_saved.connect(sigc::mem_fun(manager_, &BottleManager::update_config_and_bottles));
 }
 
 /**
  * \brief Signal bottle creation is finished, called from the thread.
  * Now we can trigger the dispatcher so it can run a method
  * (connected to the dispatcher signal) in the GUI thread
+ * \param[in] operation_id Operation number of this bottle creation
  */
-void SignalController::signal_bottle_created()
+void SignalController::signal_bottle_created(std::size_t operation_id)
 {
+  {
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    created_operations_.push_back(operation_id);
+  }
   bottle_created_dispatcher_.emit();
+  finish_bottle_operation();
 }
 
 /**
  * \brief Signal bottle updated is finished, called from the thread.
  *  Now we can trigger the dispatcher so it can run a method
  * (connected to the dispatcher signal) in the GUI thread
+ * \param[in] operation_id Operation number of this bottle update
  */
-void SignalController::signal_bottle_updated()
+void SignalController::signal_bottle_updated(std::size_t operation_id)
 {
+  {
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    updated_operations_.push_back(operation_id);
+  }
   bottle_updated_dispatcher_.emit();
+  finish_bottle_operation();
 }
 
 /**
  * \brief Signal error message during bottle creation,
  * called from the thread.
+ * \param[in] operation_id Operation number of this bottle creation
+ * \param[in] error_message Error message of this bottle creation
  */
-void SignalController::signal_error_message_during_create()
+void SignalController::signal_error_message_during_create(std::size_t operation_id, const Glib::ustring& error_message)
 {
+  {
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    create_error_messages_.emplace_back(operation_id, error_message);
+  }
   // Show error message
   error_message_created_dispatcher_.emit();
+  finish_bottle_operation();
 }
 
 /**
  * \brief Signal error message during bottle update,
  *  called from the thread.
+ * \param[in] operation_id Operation number of this bottle update
+ * \param[in] error_message Error message of this bottle update
  */
-void SignalController::signal_error_message_during_update()
+void SignalController::signal_error_message_during_update(std::size_t operation_id, const Glib::ustring& error_message)
 {
+  {
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    update_error_messages_.emplace_back(operation_id, error_message);
+  }
   // Show error message
   error_message_updated_dispatcher_.emit();
+  finish_bottle_operation();
 }
 
 /**
- * \brief Helper method for cleaning the manage thread.
+ * \brief Helper method for counting the finished bottle operations.
  */
-void SignalController::cleanup_bottle_manager_thread()
+void SignalController::finish_bottle_operation()
 {
-  if (thread_bottle_manager_)
-  {
-    if (thread_bottle_manager_->joinable())
-      thread_bottle_manager_->join();
-    delete thread_bottle_manager_;
-    thread_bottle_manager_ = nullptr;
-  }
+  std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+  --running_bottle_operations_;
+  bottle_operations_finished_.notify_all();
+}
+
+/**
+ * \brief Helper method when a bottle update is finished or failed (runs on the GUI thread).
+ * \param[in] operation_id Operation number of the bottle update
+ */
+void SignalController::finish_bottle_update(std::size_t operation_id)
+{
+  // Inform the edit window, which is only closed by the update of its last save
+  edit_window_.on_bottle_updated(operation_id);
+
+  // Update bottle list
+  manager_.update_config_and_bottles();
 }
 
 /************************************
@@ -254,50 +290,36 @@ bool SignalController::on_mouse_button_pressed(GdkEventButton* event)
 }
 
 /**
- * \brief New Bottle signal, starting NewBottle() within thread
+ * \brief New Bottle signal, creating the bottle within a job of the manager.
+ * Different bottles are created in parallel, operations on the same bottle wait on each other.
  */
-void SignalController::on_new_bottle(Glib::ustring& name,
+void SignalController::on_new_bottle(std::size_t operation_id,
+                                     Glib::ustring& name,
                                      BottleTypes::Windows windows_version,
                                      BottleTypes::Bit bit,
                                      Glib::ustring& virtual_desktop_resolution,
                                      bool& disable_geck_mono,
                                      BottleTypes::AudioDriver audio)
 {
-  if (thread_bottle_manager_)
   {
-    main_window_->show_error_message("There is already running a thread. Please wait...");
-    // Always close the wizard (signal as if the bottle was created)
-    bottle_created_dispatcher_.emit();
-  }
-  else
-  {
-    // Start a new manager thread (executing NewBottle())
-    thread_bottle_manager_ = new std::thread([this, name, windows_version, bit, virtual_desktop_resolution, disable_geck_mono, audio] {
-      manager_.new_bottle(this, name, windows_version, bit, virtual_desktop_resolution, disable_geck_mono, audio);
-    });
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    ++running_bottle_operations_;
   }
+  manager_.new_bottle(this, operation_id, name, windows_version, bit, virtual_desktop_resolution, disable_geck_mono, audio);
 }
 
 /**
- * \brief Update existing bottle signal, starting update_bottle() within thread
+ * \brief Update existing bottle signal, updating the bottle within a job of the manager
  */
 void SignalController::on_update_bottle(const UpdateBottleStruct& update_bottle_struct)
 {
-  if (thread_bottle_manager_)
   {
-    main_window_->show_error_message("There is already running a thread. Please wait...");
-    // Close the edit window (signal as if the bottle was updated)
-    error_message_updated_dispatcher_.emit();
-  }
-  else
-  {
-    // Start a new manager thread (executing NewBottle())
-    thread_bottle_manager_ = new std::thread([this, update_bottle_struct] {
-      manager_.update_bottle(this, update_bottle_struct.name, update_bottle_struct.folder_name, update_bottle_struct.description,
-                             update_bottle_struct.windows_version, update_bottle_struct.virtual_desktop_resolution, update_bottle_struct.audio,
-                             update_bottle_struct.is_debug_logging, update_bottle_struct.debug_log_level);
-    });
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    ++running_bottle_operations_;
   }
+  manager_.update_bottle(this, update_bottle_struct.operation_id, update_bottle_struct.name, update_bottle_struct.folder_name,
+                         update_bottle_struct.description, update_bottle_struct.windows_version, update_bottle_struct.virtual_desktop_resolution,
+                         update_bottle_struct.audio, update_bottle_struct.is_debug_logging, update_bottle_struct.debug_log_level);
 }
 
 /******************************************
@@ -310,10 +332,15 @@ void SignalController::on_update_bottle(const UpdateBottleStruct& update_bottle_
  */
 void SignalController::on_new_bottle_created()
 {
-  this->cleanup_bottle_manager_thread();
+  std::size_t operation_id;
+  {
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    operation_id = created_operations_.front();
+    created_operations_.pop_front();
+  }
 
   // Inform the main window (which will inform the new bottle assistant)
-  main_window_->on_new_bottle_created();
+  main_window_->on_new_bottle_created(operation_id);
 }
 
 /**
@@ -321,13 +348,13 @@ void SignalController::on_new_bottle_created()
  */
 void SignalController::on_bottle_updated()
 {
-  this->cleanup_bottle_manager_thread();
-
-  // Inform the edit window
-  edit_window_.on_bottle_updated();
-
-  // Update bottle list
-  manager_.update_config_and_bottles(false);
+  std::size_t operation_id;
+  {
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    operation_id = updated_operations_.front();
+    updated_operations_.pop_front();
+  }
+  finish_bottle_update(operation_id);
 }
 
 /**
@@ -336,12 +363,17 @@ void SignalController::on_bottle_updated()
  */
 void SignalController::on_error_message_created()
 {
-  this->cleanup_bottle_manager_thread();
+  OperationError error;
+  {
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    error = create_error_messages_.front();
+    create_error_messages_.pop_front();
+  }
 
-  // Always close the wizard (signal as if the bottle was updated)
-  bottle_created_dispatcher_.emit();
+  // Always close the wizard of this operation (as if the bottle was created)
+  main_window_->on_new_bottle_created(error.first);
 
-  main_window_->show_error_message(manager_.get_error_message());
+  main_window_->show_error_message(error.second);
 }
 
 /**
@@ -350,10 +382,23 @@ void SignalController::on_error_message_created()
  */
 void SignalController::on_error_message_updated()
 {
-  this->cleanup_bottle_manager_thread();
+  OperationError error;
+  {
+    std::lock_guard<std::mutex> lock(bottle_operations_mutex_);
+    error = update_error_messages_.front();
+    update_error_messages_.pop_front();
+  }
 
-  // Always close the edit window (signal as if the bottle was updated)
-  bottle_updated_dispatcher_.emit();
+  // Always close the edit window of this operation (as if the bottle was updated)
+  finish_bottle_update(error.first);
 
-  main_window_->show_error_message(manager_.get_error_message());
+  main_window_->show_error_message(error.second);
+}
+
+/**
+ * \brief Show the changed job list of the manager in the main window (runs on the GUI thread)
+ */
+void SignalController::on_jobs_changed()
+{
+  main_window_->set_jobs(manager_.get_jobs());
 }
@@ -0,0 +1,114 @@
+/**
+ * Copyright (c) 2023 WineGUI
+ *
+ * \file    worker_pool.cc
+ * \brief   Fixed-size pool of worker threads
+ * \author  Melroy van den Berg <webmaster1989@gmail.com>
+ *
+ * This program is free software: you can redistribute it and/or modify
+ * it under the terms of the GNU Affero General Public License as
+ * published by the Free Software Foundation, either version 3 of the
+ * License, or (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU Affero General Public License for more details.
+ *
+ * You should have received a copy of the GNU Affero General Public License
+ * along with this program.  If not, see <http://www.gnu.org/licenses/>.
+ */
+#include "worker_pool.h"
+#include <glibmm/error.h>
+#include <algorithm>
+#include <iostream>
+
+/**
+ * \brief Start the worker threads
+ * \param[in] thread_count Number of worker threads, 0 means the number of CPU cores
+ */
+WorkerPool::WorkerPool(unsigned int thread_count) : is_stopping_(false)
+{
+  if (thread_count == 0)
+  {
+    thread_count = std::max(std::thread::hardware_concurrency(), 1U);
+  }
+  threads_.reserve(thread_count);
+  for (unsigned int i = 0; i < thread_count; ++i)
+  {
+    threads_.emplace_back(&WorkerPool::worker_loop, this);
+  }
+}
+
+/**
+ * \brief Finish the already posted jobs and stop the worker threads
+ */
+WorkerPool::~WorkerPool()
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    is_stopping_ = true;
+  }
+  job_available_.notify_all();
+  for (std::thread& thread : threads_)
+  {
+    thread.join();
+  }
+}
+
+/**
+ * \brief Add a job to the queue, it will be executed by one of the worker threads
+ * \param[in] job Job function
+ */
+void WorkerPool::post(std::function<void()> job)
+{
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    jobs_.push_back(std::move(job));
+  }
+  job_available_.notify_one();
+}
+
+/**
+ * \brief Remove the posted jobs that are not started yet, running jobs are finished as usual
+ */
+void WorkerPool::cancel_pending()
+{
+  std::lock_guard<std::mutex> lock(mutex_);
+  jobs_.clear();
+}
+
+/**
+ * \brief Execute jobs until the pool is stopped (runs in worker thread)
+ */
+void WorkerPool::worker_loop()
+{
+  std::unique_lock<std::mutex> lock(mutex_);
+  while (true)
+  {
+    job_available_.wait(lock, [this] { return is_stopping_ || !jobs_.empty(); });
+    if (jobs_.empty())
+      break; // Stopping and no jobs left
+    std::function<void()> job = std::move(jobs_.front());
+    jobs_.pop_front();
+    lock.unlock();
+    try
+    {
+      job();
+    }
+    catch (const std::exception& error)
+    {
+      // Jobs should handle their own errors, never let an exception terminate the application
+      std::cout << "Error: Unhandled exception in worker thread: " << error.what() << std::endl;
+    }
+    catch (const Glib::Error& error)
+    {
+      std::cout << "Error: Unhandled exception in worker thread: " << error.what() << std::endl;
+    }
+    catch (...)
+    {
+      std::cout << "Error: Unknown exception in worker thread" << std::endl;
+    }
+    lock.lock();
+  }
+}